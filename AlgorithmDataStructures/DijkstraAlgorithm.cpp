@@ -8,6 +8,20 @@
 #include <queue>
 #include <iterator>
 #include <fstream>
+#include <memory_resource>
+#include <charconv>
+#include <cstdio>
+#include <limits>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <cstdint>
+#include <chrono>
+#include <sstream>
+#include "Instrumentation.h"
 
 using namespace std;
 
@@ -17,6 +31,9 @@ struct Station
     int x, y, z, weight, profit;
 };
 
+//Adjacency lists of (neighbour, distance), allocated from the default heap unless built in a GraphArena
+typedef pmr::vector<pmr::vector<pair<int, int>>> RouteGraph;
+
 double calculateDistance(const Station& a, const Station& b) 
 {
     return sqrt(pow(a.x - b.x, 2) + pow(a.y - b.y, 2) + pow(a.z - b.z, 2));
@@ -69,13 +86,41 @@ vector<Station> generateStations(unsigned int seed, int numStations, const vecto
 }
 
 
-// Function to generate a map of connections between stations
-vector<pair<int, int>> generateRoutes(const vector<Station>& stations, int numRoutes) 
+//Arena for the graph - the adjacency lists are carved out of one upfront block and freed together by reset()
+struct GraphArena
+{
+    pmr::monotonic_buffer_resource resource;
+
+    explicit GraphArena(size_t bytes) : resource(bytes) 
+	{
+	}
+
+    void reset() 
+	{
+        resource.release();
+    }
+};
+
+//Function to size the graph arena from the degree total, two adjacency entries per route plus the list headers
+size_t estimateGraphArenaBytes(int numStations, int numRoutes) 
+{
+    return size_t(numStations) * (sizeof(RouteGraph::value_type) + alignof(max_align_t)) + 2 * size_t(numRoutes) * sizeof(pair<int, int>);
+}
+
+//Function to size the scratch block of generateRoutes, set and map nodes are about 48 bytes - one per station, three per route
+size_t estimateRouteScratchBytes(int numStations, int numRoutes) 
+{
+    return size_t(numStations) * 2 * 48 + size_t(numRoutes) * 3 * 48;
+}
+
+// Function to generate a map of connections between stations, the temporary sets live in a scratch block taken from 'upstream' and released on return
+vector<pair<int, int>> generateRoutes(const vector<Station>& stations, int numRoutes, pmr::memory_resource* upstream = pmr::get_default_resource()) 
 {
     vector<pair<int, int>> routes;
-    set<pair<int, int>> uniqueRoutes;
+    pmr::monotonic_buffer_resource scratch(estimateRouteScratchBytes(stations.size(), numRoutes), upstream);
+    pmr::set<pair<int, int>> uniqueRoutes(&scratch);
     mt19937 rng(random_device{}());
-    map<int, set<int>> connections;
+    pmr::map<int, pmr::set<int>> connections(&scratch);
 
     // Ensure all stations have at least 3 connections
     for (int i = 0; i < stations.size(); ++i) 
@@ -106,6 +151,7 @@ vector<pair<int, int>> generateRoutes(const vector<Station>& stations, int numRo
     }
 
     // Transfer unique routes to the vector
+    routes.reserve(uniqueRoutes.size());
     for (const auto& route : uniqueRoutes) 
 	{
         routes.emplace_back(route);
@@ -114,10 +160,22 @@ vector<pair<int, int>> generateRoutes(const vector<Station>& stations, int numRo
     return routes;
 }
 
-// Function to build the graph representation
-vector<vector<pair<int, int>>> buildGraph(const vector<Station>& stations, const vector<pair<int, int>>& routes) 
+// Function to build the graph representation, every adjacency list is sized exactly and allocated from 'resource'
+RouteGraph buildGraph(const vector<Station>& stations, const vector<pair<int, int>>& routes, pmr::memory_resource* resource = pmr::get_default_resource()) 
 {
-    vector<vector<pair<int, int>>> graph(stations.size());
+    RouteGraph graph(stations.size(), resource);
+    vector<int> degree(stations.size(), 0);
+
+    for (const auto& route : routes) 
+	{
+        degree[route.first]++;
+        degree[route.second]++;
+    }
+
+    for (size_t i = 0; i < stations.size(); ++i) 
+	{
+        graph[i].reserve(degree[i]);
+    }
 
     for (const auto& route : routes) 
 	{
@@ -132,9 +190,225 @@ vector<vector<pair<int, int>>> buildGraph(const vector<Station>& stations, const
     return graph;
 }
 
+//Relabelling of the stations for memory locality, newId[old] is a station's position in the new order and oldId[new] maps it back
+struct VertexOrder
+{
+	vector<int> newId;
+	vector<int> oldId;
+};
+
+//Function to build the order from the list of old ids in their new sequence
+VertexOrder makeVertexOrder(const vector<int>& sequence)
+{
+	VertexOrder order;
+	order.oldId = sequence;
+	order.newId.resize(sequence.size());
+
+	for(size_t i = 0 ; i < sequence.size() ; ++i)
+		order.newId[sequence[i]] = i;
+
+	return order;
+}
+
+//Function to compute the position of a point on a 3D Hilbert curve with 'bits' bits per axis (Skilling's transpose method)
+uint64_t hilbertIndex(uint32_t x, uint32_t y, uint32_t z, int bits)
+{
+	uint32_t axes[3] = {x, y, z};
+
+	//undo the excess rotations and reflections, highest bit first
+	for(uint32_t q = 1u << (bits - 1) ; q > 1 ; q >>= 1)
+	{
+		uint32_t p = q - 1;
+
+		for(int i = 0 ; i < 3 ; ++i)
+		{
+			if(axes[i] & q)
+			{
+				axes[0] ^= p;
+			}
+			else
+			{
+				uint32_t t = (axes[0] ^ axes[i]) & p;
+				axes[0] ^= t;
+				axes[i] ^= t;
+			}
+		}
+	}
+
+	//Gray encode
+	axes[1] ^= axes[0];
+	axes[2] ^= axes[1];
+	uint32_t t = 0;
+
+	for(uint32_t q = 1u << (bits - 1) ; q > 1 ; q >>= 1)
+		if(axes[2] & q)
+			t ^= q - 1;
+
+	for(int i = 0 ; i < 3 ; ++i)
+		axes[i] ^= t;
+
+	//interleave the transposed bits into one key
+	uint64_t index = 0;
+
+	for(int bit = bits - 1 ; bit >= 0 ; --bit)
+		for(int i = 0 ; i < 3 ; ++i)
+			index = (index << 1) | ((axes[i] >> bit) & 1);
+
+	return index;
+}
+
+//Function to order the stations along a Hilbert curve over x, y and z, so stations close in space get close ids
+VertexOrder hilbertOrder(const vector<Station>& stations)
+{
+	const int bits = 16;
+	int low[3] = {numeric_limits<int> :: max(), numeric_limits<int> :: max(), numeric_limits<int> :: max()};
+	int high[3] = {numeric_limits<int> :: min(), numeric_limits<int> :: min(), numeric_limits<int> :: min()};
+
+	for(const Station& station : stations)
+	{
+		int position[3] = {station.x, station.y, station.z};
+
+		for(int axis = 0 ; axis < 3 ; ++axis)
+		{
+			low[axis] = min(low[axis], position[axis]);
+			high[axis] = max(high[axis], position[axis]);
+		}
+	}
+
+	//scale every axis onto the 2^bits grid of the curve
+	vector<pair<uint64_t, int>> keys(stations.size());
+
+	for(size_t i = 0 ; i < stations.size() ; ++i)
+	{
+		int position[3] = {stations[i].x, stations[i].y, stations[i].z};
+		uint32_t cell[3];
+
+		for(int axis = 0 ; axis < 3 ; ++axis)
+		{
+			double span = max(1.0, double(high[axis]) - low[axis]);
+			cell[axis] = uint32_t((double(position[axis]) - low[axis]) / span * ((1u << bits) - 1));
+		}
+
+		keys[i] = {hilbertIndex(cell[0], cell[1], cell[2], bits), int(i)};
+	}
+
+	sort(keys.begin(), keys.end());
+	vector<int> sequence(stations.size());
+
+	for(size_t i = 0 ; i < keys.size() ; ++i)
+		sequence[i] = keys[i].second;
+
+	return makeVertexOrder(sequence);
+}
+
+//Function to order the stations by reverse Cuthill-McKee - a BFS from a low degree station visiting neighbours by increasing degree, reversed
+VertexOrder cuthillMcKeeOrder(const RouteGraph& graph)
+{
+	int n = graph.size();
+	vector<int> byDegree(n);
+	vector<bool> visited(n, false);
+	vector<int> sequence;
+	sequence.reserve(n);
+
+	for(int i = 0 ; i < n ; ++i)
+		byDegree[i] = i;
+
+	auto lowerDegree = [&](int a, int b) { return graph[a].size() < graph[b].size(); };
+	stable_sort(byDegree.begin(), byDegree.end(), lowerDegree);
+
+	//one BFS per component, the queue is the tail of 'sequence'
+	for(int start : byDegree)
+	{
+		if(visited[start])
+			continue;
+
+		visited[start] = true;
+		sequence.push_back(start);
+
+		for(size_t head = sequence.size() - 1 ; head < sequence.size() ; ++head)
+		{
+			size_t first = sequence.size();
+
+			for(const auto& neighbour : graph[sequence[head]])
+			{
+				if(!visited[neighbour.first])
+				{
+					visited[neighbour.first] = true;
+					sequence.push_back(neighbour.first);
+				}
+			}
+
+			stable_sort(sequence.begin() + first, sequence.end(), lowerDegree);
+		}
+	}
+
+	reverse(sequence.begin(), sequence.end());
+	return makeVertexOrder(sequence);
+}
+
+//Function to relabel the stations, station i of the result is station order.oldId[i] of the input
+vector<Station> reorderStations(const vector<Station>& stations, const VertexOrder& order)
+{
+	vector<Station> reordered;
+	reordered.reserve(stations.size());
+
+	for(int old : order.oldId)
+		reordered.push_back(stations[old]);
+
+	return reordered;
+}
+
+//Function to relabel the end points of every route
+vector<pair<int, int>> reorderRoutes(const vector<pair<int, int>>& routes, const VertexOrder& order)
+{
+	vector<pair<int, int>> reordered;
+	reordered.reserve(routes.size());
+
+	for(const auto& route : routes)
+		reordered.push_back(minmax(order.newId[route.first], order.newId[route.second]));
+
+	return reordered;
+}
+
+//Function to relabel a graph, adjacency lists come out sorted by the new ids so each scan walks 'distance' forwards
+RouteGraph reorderGraph(const RouteGraph& graph, const VertexOrder& order, pmr::memory_resource* resource = pmr::get_default_resource())
+{
+	RouteGraph reordered(graph.size(), resource);
+
+	for(size_t i = 0 ; i < graph.size() ; ++i)
+	{
+		auto& adjacent = reordered[i];
+		adjacent.reserve(graph[order.oldId[i]].size());
+
+		for(const auto& neighbour : graph[order.oldId[i]])
+			adjacent.push_back({order.newId[neighbour.first], neighbour.second});
+
+		sort(adjacent.begin(), adjacent.end());
+	}
+
+	return reordered;
+}
+
+//Function to map a distance / previous pair computed on a relabelled graph back to the original station ids
+void restoreVertexIds(const VertexOrder& order, vector<int>& distance, vector<int>& previous)
+{
+	vector<int> restoredDistance(distance.size());
+	vector<int> restoredPrevious(previous.size());
+
+	for(size_t i = 0 ; i < distance.size() ; ++i)
+	{
+		restoredDistance[order.oldId[i]] = distance[i];
+		restoredPrevious[order.oldId[i]] = previous[i] == -1 ? -1 : order.oldId[previous[i]];
+	}
+
+	distance.swap(restoredDistance);
+	previous.swap(restoredPrevious);
+}
+
 //Dijkstra's Algorithm
-void DijkstraAlgorithm(const vector<vector<pair<int, int>>>& graph, int start, vector<int>& distance, vector<int>& previous)
+void DijkstraAlgorithm(const RouteGraph& graph, int start, vector<int>& distance, vector<int>& previous)
 {
+	INSTRUMENT_PHASE("dijkstra");
 	priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;		//declares priority queue 'pq' of pairs
 	
 	distance[start] = 0;	//initializes distance starting node as 0
@@ -145,9 +419,11 @@ void DijkstraAlgorithm(const vector<vector<pair<int, int>>>& graph, int start, v
 		int current = pq.top().second ;
 		int currentDistance = pq.top().first ;
 		pq.pop();
+		INSTRUMENT_COUNT("dijkstra.pops", 1);
 		
 		if(currentDistance > distance[current])
 		{
+			INSTRUMENT_COUNT("dijkstra.stalePops", 1);
 			continue ;
 		}
 		
@@ -158,6 +434,7 @@ void DijkstraAlgorithm(const vector<vector<pair<int, int>>>& graph, int start, v
 			
 			if(distance[current] + weight < distance[next])	
 			{
+				INSTRUMENT_COUNT("dijkstra.relaxations", 1);
 				distance[next] = distance[current] + weight;	//if new distance is shorter, it will update the distance of the neighbour
 				previous[next] = current;
 				pq.push({distance[next], next});				//add neighbour to priority queue with updated distance
@@ -166,133 +443,1933 @@ void DijkstraAlgorithm(const vector<vector<pair<int, int>>>& graph, int start, v
 	}
 }
 
-//Print shortest path
-void shortestPath(const vector<int>& distance, const vector<int>& previous, int start)
+//Shortest path tree for one source kept up to date as routes open, close or change length
+struct DynamicShortestPaths
 {
-	for(int i=0; i<distance.size(); ++i)	//iterates through all stations in graph
+	RouteGraph graph;
+	int source;
+	vector<int> distance;
+	vector<int> previous;
+};
+
+//Function to compute the initial shortest path tree for the dynamic mode
+DynamicShortestPaths initDynamicShortestPaths(const RouteGraph& graph, int source)
+{
+	DynamicShortestPaths paths;
+	paths.graph = graph;
+	paths.source = source;
+	paths.distance.assign(graph.size(), numeric_limits<int> :: max());
+	paths.previous.assign(graph.size(), -1);
+	
+	DijkstraAlgorithm(paths.graph, source, paths.distance, paths.previous);
+	
+	return paths;
+}
+
+//Function to continue Dijkstra from the queued vertices, returns the number of vertices whose distance improved
+int propagateDistances(DynamicShortestPaths& paths, priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>>& pq)
+{
+	int changed = 0;
+	
+	while(!pq.empty())
 	{
-		cout << "Shortest path from Station " << start << " to Station " << i << " is " << distance[i] << endl ;
-		cout << "Shortest path : " ;
+		int current = pq.top().second ;
+		int currentDistance = pq.top().first ;
+		pq.pop();
 		
-		int current = i ;
+		if(currentDistance > paths.distance[current])
+			continue ;
 		
-		while(current != -1)	//loop continue as long as current node is not -1
+		changed++;
+		
+		for(const auto& neighbour : paths.graph[current])
 		{
-			cout << current << " " ;
-			current = previous[current];	//update current note index to be its previous
+			int next = neighbour.first;
+			
+			if(currentDistance + neighbour.second < paths.distance[next])
+			{
+				paths.distance[next] = currentDistance + neighbour.second;
+				paths.previous[next] = current;
+				pq.push({paths.distance[next], next});
+			}
 		}
-		
-		cout << endl << endl ;
 	}
+	
+	return changed;
 }
 
-//Function to generate Grapgviz for shortest path Dijkstra's Algorithm
-void graphShortestPath(const vector<Station>& stations, const vector<pair<int, int>>& routes, const vector<int>& previous)
+//Function to drop the subtree rooted at 'root' and recompute it from its unaffected neighbours, returns the subtree size
+int invalidateSubtree(DynamicShortestPaths& paths, int root)
 {
-	ofstream dotFile("shortestPathGraph.dot");
+	//collects the subtree by following previous pointers downwards from the root
+	vector<int> affected = {root};
 	
-	dotFile << "graph G { " << endl ;
-	
-	//Nodes
-	for(const Station& station : stations)
+	for(size_t i = 0 ; i < affected.size() ; ++i)
 	{
-		dotFile << "    " << station.name << " [label=\"" << 
-					station.name << "\", shape=circle];" << endl;
+		for(const auto& neighbour : paths.graph[affected[i]])
+		{
+			if(paths.previous[neighbour.first] == affected[i])
+				affected.push_back(neighbour.first);
+		}
 	}
 	
-	//Edges
-	for(const auto& route : routes)
+	for(int vertex : affected)
 	{
-		dotFile << "    " << stations[route.first].name << " -- " 
-					<< stations[route.second].name;
-		dotFile << " [label=\"" << calculateDistance(stations[route.first], stations[route.second]) << "\"];" << endl;
+		paths.distance[vertex] = numeric_limits<int> :: max();
+		paths.previous[vertex] = -1;
 	}
 	
-	//Shortest path
-	for(size_t i = 0 ; i < stations.size() ; ++i)
-	{
-	    int current = i ;
+	//seeds every affected vertex with its best distance through an unaffected neighbour
+	priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
 	
-	    while(current != -1 && previous[current] != -1)
-	    {
-	        dotFile << "    " << stations[current].name << " -- " << stations[previous[current]].name << " [color=red];" << endl;
-	        current = previous[current] ;
-	    }
+	for(int vertex : affected)
+	{
+		for(const auto& neighbour : paths.graph[vertex])
+		{
+			int from = neighbour.first;
+			
+			if(paths.distance[from] != numeric_limits<int> :: max() && paths.distance[from] + neighbour.second < paths.distance[vertex])
+			{
+				paths.distance[vertex] = paths.distance[from] + neighbour.second;
+				paths.previous[vertex] = from;
+			}
+		}
+		
+		if(paths.distance[vertex] != numeric_limits<int> :: max())
+			pq.push({paths.distance[vertex], vertex});
 	}
-
-	dotFile << "}" << endl ;
-	dotFile.close();
+	
+	propagateDistances(paths, pq);
+	
+	return affected.size();
 }
 
-int main() 
+//Function to set the length of the route between a and b, adding the route if it does not exist
+int updateRoute(DynamicShortestPaths& paths, int a, int b, int weight)
 {
-    long long seedSum = 1201100116LL + 1201201773LL + 1201201862LL;
-    vector<int> seedDigits;
-    long long tempSeedSum = seedSum;
-    
-	while (tempSeedSum > 0) 
-	{
-        seedDigits.push_back(tempSeedSum % 10);
-        tempSeedSum /= 10;
-    }
-    reverse(seedDigits.begin(), seedDigits.end());
-
-    vector<Station> stations = generateStations(static_cast<unsigned int>(seedSum), 20, seedDigits);
-    vector<pair<int, int>> routes = generateRoutes(stations, 54);
-
-    for (const Station& station : stations) 
-	{
-        cout << station.name << " "
-                  << station.x << " "
-                  << station.y << " "
-                  << station.z << " "
-                  << station.weight << " "
-                  << station.profit << endl;
-    }
-    
-    cout << endl ;
-
-    for (const auto& route : routes) 
+	int oldWeight = numeric_limits<int> :: max();
+	
+	for(int end = 0 ; end < 2 ; ++end)
 	{
-        cout << "Route between " << stations[route.first].name
-                  << " (" << route.first << ")"
-                  << " and " << stations[route.second].name
-                  << " (" << route.second << ")"
-                  << " Distance: " << calculateDistance(stations[route.first], stations[route.second])
-                  << endl;
-    }
-    
-    vector<vector<pair<int, int>>> graph = buildGraph(stations, routes);
+		int from = end == 0 ? a : b;
+		int to = end == 0 ? b : a;
+		bool found = false;
+		
+		for(auto& neighbour : paths.graph[from])
+		{
+			if(neighbour.first == to)
+			{
+				oldWeight = neighbour.second;
+				neighbour.second = weight;
+				found = true;
+			}
+		}
+		
+		if(!found)
+			paths.graph[from].push_back({to, weight});
+	}
 	
-	int startStation = 0 ;
+	priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
 	
-	vector<int> distance(stations.size(), numeric_limits<int> :: max());
-	vector<int> previous(stations.size(), -1);
+	if(weight > oldWeight)		//a longer route can only hurt the subtree hanging from it
+	{
+		if(paths.previous[b] == a)
+			return invalidateSubtree(paths, b);
+		
+		if(paths.previous[a] == b)
+			return invalidateSubtree(paths, a);
+		
+		return 0;
+	}
 	
-	DijkstraAlgorithm(graph, startStation, distance, previous);
+	//a shorter or new route can only improve the vertices reached through it
+	for(int end = 0 ; end < 2 ; ++end)
+	{
+		int from = end == 0 ? a : b;
+		int to = end == 0 ? b : a;
+		
+		if(paths.distance[from] != numeric_limits<int> :: max() && paths.distance[from] + weight < paths.distance[to])
+		{
+			paths.distance[to] = paths.distance[from] + weight;
+			paths.previous[to] = from;
+			pq.push({paths.distance[to], to});
+		}
+	}
 	
-	cout << endl ;
+	return propagateDistances(paths, pq);
+}
+
+//Function to close the route between a and b
+int removeRoute(DynamicShortestPaths& paths, int a, int b)
+{
+	for(int end = 0 ; end < 2 ; ++end)
+	{
+		int from = end == 0 ? a : b;
+		int to = end == 0 ? b : a;
+		auto& edges = paths.graph[from];
+		
+		edges.erase(remove_if(edges.begin(), edges.end(), [to](const pair<int, int>& neighbour) { return neighbour.first == to; }), edges.end());
+	}
 	
-	//print Shortest Path
-	shortestPath(distance, previous, startStation);
+	if(paths.previous[b] == a)
+		return invalidateSubtree(paths, b);
 	
-	// Generate Graphviz DOT file
-    graphShortestPath(stations, routes, previous);
-
-    // Inform the user
-    cout << "Graphviz DOT file generated: shortestPathGraph.dot" << endl;
-
-    return 0;
+	if(paths.previous[a] == b)
+		return invalidateSubtree(paths, a);
+	
+	return 0;
 }
 
+//Structure for a relaxation request produced while scanning a bucket
+struct RelaxRequest
+{
+	int vertex;
+	int distance;
+	int parent;
+};
 
-/*
-HOW TO RUN THE GRAPH : USING COMMAND PROMPT
-C:\Users\Elyana>E:
-
-E:\>cd "MMU Degree\Sem4\Algorithm Design Analysis\Assignment\Q3"
-
-E:\MMU Degree\Sem4\Algorithm Design Analysis\Assignment\Q3>dot -Tpng shortestPathGraph.dot -o shortestPathGraph.png
-
-E:\MMU Degree\Sem4\Algorithm Design Analysis\Assignment\Q3>
+//Persistent pool for a run of parallel steps - run(job) calls job(t) for every thread t and returns once all are done,
+//the calling thread acts as thread 0 so a one-thread pool starts nothing
+struct WorkerPool
+{
+	int numThreads;
+	vector<thread> threads;
+	mutex lock;
+	condition_variable wake, finished;
+	function<void(int)> job;
+	long long generation = 0;
+	int running = 0;
+	bool stopping = false;
+	
+	explicit WorkerPool(int count) : numThreads(count)
+	{
+		for(int t = 1 ; t < numThreads ; ++t)
+			threads.emplace_back([this, t] { loop(t); });
+	}
+	
+	~WorkerPool()
+	{
+		{
+			lock_guard<mutex> guard(lock);
+			stopping = true;
+		}
+		
+		wake.notify_all();
+		
+		for(thread& worker : threads)
+			worker.join();
+	}
+	
+	void loop(int self)
+	{
+		long long seen = 0;
+		unique_lock<mutex> guard(lock);
+		
+		while(true)
+		{
+			wake.wait(guard, [&] { return stopping || generation != seen; });
+			
+			if(stopping)
+				return ;
+			
+			seen = generation;
+			guard.unlock();
+			job(self);
+			guard.lock();
+			
+			if(--running == 0)
+				finished.notify_one();
+		}
+	}
+	
+	void run(const function<void(int)>& task)
+	{
+		if(numThreads == 1)
+		{
+			task(0);
+			return ;
+		}
+		
+		{
+			lock_guard<mutex> guard(lock);
+			job = task;
+			running = numThreads - 1;
+			generation++;
+		}
+		
+		wake.notify_all();
+		task(0);
+		
+		unique_lock<mutex> guard(lock);
+		finished.wait(guard, [&] { return running == 0; });
+	}
+};
+
+//Delta-stepping - buckets of width delta are settled in order, scanning the edges of each bucket in parallel
+//Every thread owns a contiguous range of stations with its own buckets. A phase scans the owned frontier into
+//per-owner request lists, then each thread applies the requests aimed at its own stations, so relaxations run
+//in parallel without locks. Phases big enough to pay for it go to a pool started once for the run, small ones
+//run on the calling thread over the same per-owner lists.
+void DeltaSteppingAlgorithm(const RouteGraph& graph, int start, vector<int>& distance, vector<int>& previous, int delta = 0, int numThreads = 0)
+{
+	int numOfVertices = graph.size();
+	int maxWeight = 1;
+	long long numEdges = 0;
+	
+	for(const auto& edges : graph)
+	{
+		numEdges += edges.size();
+		
+		for(const auto& neighbour : edges)
+			maxWeight = max(maxWeight, neighbour.second);
+	}
+	
+	if(delta <= 0)		//picks delta as the heaviest route divided by the average degree
+		delta = max(1LL, maxWeight / max(1LL, numEdges / max(1, numOfVertices)));
+	
+	if(numThreads <= 0)
+		numThreads = max(1u, thread::hardware_concurrency());
+	
+	const size_t minParallel = 1 << 14;		//smallest phase worth waking the pool for
+	int workers = max(1, min<int>(numThreads, numOfVertices / minParallel));
+	int rangeSize = (numOfVertices + workers - 1) / workers;
+	auto owner = [&](int vertex) { return vertex / rangeSize; };
+	
+	//buckets are reused cyclically, no pending distance is ever more than maxWeight past the current bucket
+	int numBuckets = maxWeight / delta + 2;
+	vector<vector<vector<int>>> buckets(workers, vector<vector<int>>(numBuckets));
+	vector<vector<vector<RelaxRequest>>> outbox(workers, vector<vector<RelaxRequest>>(workers));	//outbox[from][to]
+	vector<vector<int>> frontier(workers), settledHere(workers), entries(workers);
+	vector<long long> pending(workers, 0);
+	vector<int> scanned(numOfVertices, -1), settled(numOfVertices, -1);
+	WorkerPool pool(workers);
+	int round = 0;
+	
+	//runs one step for every owner, on the pool when 'size' items are worth it
+	auto step = [&](size_t size, const function<void(int)>& phase)
+	{
+		if(size >= minParallel)
+			pool.run(phase);
+		else
+			for(int t = 0 ; t < workers ; ++t)
+				phase(t);
+	};
+	
+	auto bucketSize = [&](int index)
+	{
+		size_t size = 0;
+		
+		for(int t = 0 ; t < workers ; ++t)
+			size += buckets[t][index % numBuckets].size();
+		
+		return size;
+	};
+	
+	//queues a request for every light or heavy edge that improves its target, the targets are only read here
+	auto scan = [&](int self, const vector<int>& from, bool light)
+	{
+		for(int current : from)
+		{
+			for(const auto& neighbour : graph[current])
+			{
+				if((neighbour.second <= delta) == light && distance[current] + neighbour.second < distance[neighbour.first])
+					outbox[self][owner(neighbour.first)].push_back({neighbour.first, distance[current] + neighbour.second, current});
+			}
+		}
+	};
+	
+	//relaxes the requests every owner queued for the stations of 'self'
+	auto apply = [&](int self)
+	{
+		for(int from = 0 ; from < workers ; ++from)
+		{
+			for(const RelaxRequest& request : outbox[from][self])
+			{
+				if(request.distance < distance[request.vertex])
+				{
+					distance[request.vertex] = request.distance;
+					previous[request.vertex] = request.parent;
+					buckets[self][(request.distance / delta) % numBuckets].push_back(request.vertex);
+					pending[self]++;
+				}
+			}
+			
+			outbox[from][self].clear();
+		}
+	};
+	
+	auto requestCount = [&]()
+	{
+		size_t count = 0;
+		
+		for(const auto& row : outbox)
+			for(const auto& requests : row)
+				count += requests.size();
+		
+		return count;
+	};
+	
+	distance[start] = 0;
+	buckets[owner(start)][0].push_back(start);
+	pending[owner(start)] = 1;
+	
+	for(int index = 0 ; ; )
+	{
+		for(auto& vertices : settledHere)
+			vertices.clear();
+		
+		for(size_t size = bucketSize(index) ; size > 0 ; size = bucketSize(index))		//light edges can refill the current bucket
+		{
+			round++;
+			
+			step(size, [&](int self)
+			{
+				entries[self].clear();
+				entries[self].swap(buckets[self][index % numBuckets]);
+				pending[self] -= entries[self].size();
+				frontier[self].clear();
+				
+				for(int vertex : entries[self])
+				{
+					//skips stale entries and duplicates within this round
+					if(distance[vertex] / delta != index || scanned[vertex] == round)
+						continue ;
+					
+					scanned[vertex] = round;
+					frontier[self].push_back(vertex);
+					
+					if(settled[vertex] != index)
+					{
+						settled[vertex] = index;
+						settledHere[self].push_back(vertex);
+					}
+				}
+				
+				scan(self, frontier[self], true);
+			});
+			
+			step(requestCount(), apply);
+		}
+		
+		size_t heavy = 0;
+		
+		for(const auto& vertices : settledHere)
+			heavy += vertices.size();
+		
+		step(heavy, [&](int self) { scan(self, settledHere[self], false); });
+		step(requestCount(), apply);
+		
+		long long total = 0;
+		
+		for(long long count : pending)
+			total += count;
+		
+		if(total == 0)
+			break ;
+		
+		//moves on to the next bucket that holds any entry
+		do
+		{
+			index++;
+		}
+		while(bucketSize(index) == 0);
+	}
+}
+
+//Buffered writer for large results, formats numbers in place and writes to the stream in large blocks
+struct OutputBuffer
+{
+	ostream& out;
+	string buffer;
+	size_t capacity;
+	
+	explicit OutputBuffer(ostream& stream, size_t bufferSize = 1 << 16) : out(stream), capacity(bufferSize)
+	{
+		buffer.reserve(capacity);
+	}
+	
+	~OutputBuffer()
+	{
+		flush();
+	}
+	
+	void flush()
+	{
+		out.write(buffer.data(), buffer.size());
+		buffer.clear();
+	}
+	
+	OutputBuffer& operator<<(const string& text)
+	{
+		buffer += text;
+		if(buffer.size() >= capacity)
+			flush();
+		return *this;
+	}
+	
+	OutputBuffer& operator<<(const char* text)
+	{
+		buffer += text;
+		if(buffer.size() >= capacity)
+			flush();
+		return *this;
+	}
+	
+	OutputBuffer& operator<<(char c)
+	{
+		buffer += c;
+		if(buffer.size() >= capacity)
+			flush();
+		return *this;
+	}
+	
+	OutputBuffer& operator<<(long long value)
+	{
+		char digits[24];
+		char* end = to_chars(digits, digits + sizeof(digits), value).ptr;
+		buffer.append(digits, end);
+		if(buffer.size() >= capacity)
+			flush();
+		return *this;
+	}
+	
+	OutputBuffer& operator<<(int value)
+	{
+		return *this << static_cast<long long>(value);
+	}
+	
+	OutputBuffer& operator<<(double value)		//same digits as the default ostream formatting
+	{
+		char digits[32];
+		int length = snprintf(digits, sizeof(digits), "%g", value);
+		buffer.append(digits, length);
+		if(buffer.size() >= capacity)
+			flush();
+		return *this;
+	}
+};
+
+//Print shortest path
+void shortestPath(const vector<int>& distance, const vector<int>& previous, int start)
+{
+	OutputBuffer out(cout);
+	
+	for(int i=0; i<distance.size(); ++i)	//iterates through all stations in graph
+	{
+		out << "Shortest path from Station " << start << " to Station " << i << " is " << distance[i] << '\n' ;
+		out << "Shortest path : " ;
+		
+		int current = i ;
+		
+		while(current != -1)	//loop continue as long as current node is not -1
+		{
+			out << current << ' ' ;
+			current = previous[current];	//update current note index to be its previous
+		}
+		
+		out << "\n\n" ;
+	}
+	
+	out.flush();
+	cout.flush();
+}
+
+//Function to generate Grapgviz for shortest path Dijkstra's Algorithm
+void graphShortestPath(const vector<Station>& stations, const vector<pair<int, int>>& routes, const vector<int>& previous)
+{
+	ofstream dotFile("shortestPathGraph.dot");
+	OutputBuffer out(dotFile);
+	
+	out << "graph G { \n" ;
+	
+	//Nodes
+	for(const Station& station : stations)
+	{
+		out << "    " << station.name << " [label=\"" << 
+					station.name << "\", shape=circle];\n";
+	}
+	
+	//Edges
+	for(const auto& route : routes)
+	{
+		out << "    " << stations[route.first].name << " -- " 
+					<< stations[route.second].name;
+		out << " [label=\"" << calculateDistance(stations[route.first], stations[route.second]) << "\"];\n";
+	}
+	
+	//Shortest path - every tree edge is written once, from each station to its previous
+	for(size_t i = 0 ; i < stations.size() ; ++i)
+	{
+	    if(previous[i] != -1)
+	    {
+	        out << "    " << stations[i].name << " -- " << stations[previous[i]].name << " [color=red];\n";
+	    }
+	}
+
+	out << "}\n" ;
+	out.flush();
+	dotFile.close();
+}
+
+//Function to dump distance and previous as CSV with one row per station
+bool writeShortestPathCSV(const vector<int>& distance, const vector<int>& previous, const string& fileName)
+{
+	ofstream file(fileName);
+	
+	if(!file)
+		return false;
+	
+	OutputBuffer out(file);
+	out << "station,distance,previous\n";
+	
+	for(size_t i = 0 ; i < distance.size() ; ++i)
+		out << static_cast<long long>(i) << ',' << distance[i] << ',' << previous[i] << '\n';
+	
+	out.flush();
+	return static_cast<bool>(file);
+}
+
+//Function to dump distance and previous as a binary file - "SPT1", station count, then both arrays as 32-bit integers
+bool writeShortestPathBinary(const vector<int>& distance, const vector<int>& previous, const string& fileName)
+{
+	ofstream file(fileName, ios::binary);
+	
+	if(!file)
+		return false;
+	
+	int numOfVertices = distance.size();
+	
+	file.write("SPT1", 4);
+	file.write(reinterpret_cast<const char*>(&numOfVertices), sizeof(numOfVertices));
+	file.write(reinterpret_cast<const char*>(distance.data()), numOfVertices * sizeof(int));
+	file.write(reinterpret_cast<const char*>(previous.data()), numOfVertices * sizeof(int));
+	
+	return static_cast<bool>(file);
+}
+
+//Structure for an edge of the contraction hierarchy, middle is -1 for an original route
+struct CHEdge
+{
+	int to;
+	int weight;
+	int middle;
+};
+
+//Contraction hierarchy - rank of every station and the edges leading to higher ranked stations
+struct ContractionHierarchy
+{
+	vector<int> rank;
+	vector<vector<CHEdge>> upward;
+	int numShortcuts = 0;
+};
+
+//Scratch space for the bounded witness searches run during contraction
+struct WitnessSearch
+{
+	vector<int> distance;
+	vector<int> touched;
+};
+
+//Function to find the shortest distance from source to every other remaining node without passing through 'skip'
+void witnessSearch(const vector<vector<CHEdge>>& remaining, const vector<bool>& contracted, int source, int skip, int maxDistance, int settleLimit, WitnessSearch& search)
+{
+	for(int node : search.touched)		//resets only the nodes touched by the previous search
+		search.distance[node] = numeric_limits<int> :: max();
+	search.touched.clear();
+	
+	priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+	
+	search.distance[source] = 0;
+	search.touched.push_back(source);
+	pq.push({0, source});
+	
+	int settled = 0;
+	
+	while(!pq.empty())
+	{
+		int current = pq.top().second ;
+		int currentDistance = pq.top().first ;
+		pq.pop();
+		
+		if(currentDistance > search.distance[current])
+			continue ;
+		
+		if(currentDistance > maxDistance || ++settled > settleLimit)	//no witness can be shorter than maxDistance
+			break ;
+		
+		for(const CHEdge& edge : remaining[current])
+		{
+			if(edge.to == skip || contracted[edge.to])
+				continue ;
+			
+			int newDistance = currentDistance + edge.weight;
+			
+			if(newDistance < search.distance[edge.to])
+			{
+				if(search.distance[edge.to] == numeric_limits<int> :: max())
+					search.touched.push_back(edge.to);
+				
+				search.distance[edge.to] = newDistance;
+				pq.push({newDistance, edge.to});
+			}
+		}
+	}
+}
+
+//Function to contract a node, when simulate is true it only counts the shortcuts that would be added
+int contractNode(vector<vector<CHEdge>>& remaining, const vector<bool>& contracted, int node, bool simulate, WitnessSearch& search)
+{
+	const int settleLimit = simulate ? 50 : 500;	//priorities only need an estimate, so simulation searches less
+	vector<CHEdge> neighbours;
+	
+	for(const CHEdge& edge : remaining[node])
+	{
+		if(!contracted[edge.to])
+			neighbours.push_back(edge);
+	}
+	
+	int maxOutgoing = 0;
+	
+	for(const CHEdge& edge : neighbours)
+		maxOutgoing = max(maxOutgoing, edge.weight);
+	
+	vector<CHEdge> shortcuts;	//shortcuts stored as (from, to, weight) in the fields (middle, to, weight)
+	
+	for(size_t i = 0 ; i < neighbours.size() ; ++i)
+	{
+		int source = neighbours[i].to;
+		
+		witnessSearch(remaining, contracted, source, node, neighbours[i].weight + maxOutgoing, settleLimit, search);
+		
+		for(size_t j = i + 1 ; j < neighbours.size() ; ++j)
+		{
+			int target = neighbours[j].to;
+			int viaNode = neighbours[i].weight + neighbours[j].weight;
+			
+			if(search.distance[target] > viaNode)	//no witness path, the shortcut is needed
+				shortcuts.push_back({target, viaNode, source});
+		}
+	}
+	
+	if(simulate)
+		return shortcuts.size();
+	
+	for(const CHEdge& shortcut : shortcuts)
+	{
+		int a = shortcut.middle;
+		int b = shortcut.to;
+		
+		//keeps a single edge per pair of nodes, updating it if the shortcut is shorter
+		auto insertEdge = [&](int from, int to)
+		{
+			for(CHEdge& edge : remaining[from])
+			{
+				if(edge.to == to)
+				{
+					if(shortcut.weight < edge.weight)
+					{
+						edge.weight = shortcut.weight;
+						edge.middle = node;
+					}
+					return ;
+				}
+			}
+			remaining[from].push_back({to, shortcut.weight, node});
+		};
+		
+		insertEdge(a, b);
+		insertEdge(b, a);
+	}
+	
+	return shortcuts.size();
+}
+
+//Function to build the contraction hierarchy, nodes are ordered by edge difference with lazy updates
+ContractionHierarchy buildContractionHierarchy(const RouteGraph& graph)
+{
+	int numOfVertices = graph.size();
+	ContractionHierarchy hierarchy;
+	hierarchy.rank.assign(numOfVertices, -1);
+	hierarchy.upward.assign(numOfVertices, vector<CHEdge>());
+	
+	//copies the graph keeping only the shortest of any parallel routes
+	vector<vector<CHEdge>> remaining(numOfVertices);
+	
+	for(int u = 0 ; u < numOfVertices ; ++u)
+	{
+		for(const auto& neighbour : graph[u])
+		{
+			if(neighbour.first == u)
+				continue ;
+			
+			bool found = false;
+			
+			for(CHEdge& edge : remaining[u])
+			{
+				if(edge.to == neighbour.first)
+				{
+					edge.weight = min(edge.weight, neighbour.second);
+					found = true;
+				}
+			}
+			
+			if(!found)
+				remaining[u].push_back({neighbour.first, neighbour.second, -1});
+		}
+	}
+	
+	vector<bool> contracted(numOfVertices, false);
+	vector<int> contractedNeighbours(numOfVertices, 0);
+	WitnessSearch search;
+	search.distance.assign(numOfVertices, numeric_limits<int> :: max());
+	
+	//priority is the edge difference plus the number of already contracted neighbours
+	auto priority = [&](int node)
+	{
+		int degree = 0;
+		
+		for(const CHEdge& edge : remaining[node])
+		{
+			if(!contracted[edge.to])
+				degree++;
+		}
+		
+		return contractNode(remaining, contracted, node, true, search) - degree + contractedNeighbours[node];
+	};
+	
+	priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> pq;
+	
+	for(int node = 0 ; node < numOfVertices ; ++node)
+		pq.push({priority(node), node});
+	
+	int order = 0;
+	
+	while(!pq.empty())
+	{
+		int node = pq.top().second ;
+		pq.pop();
+		
+		if(contracted[node])
+			continue ;
+		
+		int newPriority = priority(node);
+		
+		if(!pq.empty() && newPriority > pq.top().first)	//priority went stale, try again later
+		{
+			pq.push({newPriority, node});
+			continue ;
+		}
+		
+		hierarchy.numShortcuts += contractNode(remaining, contracted, node, false, search);
+		hierarchy.rank[node] = order++;
+		contracted[node] = true;
+		
+		for(const CHEdge& edge : remaining[node])
+		{
+			if(contracted[edge.to])
+				continue ;
+			
+			hierarchy.upward[node].push_back(edge);		//every remaining neighbour is ranked higher
+			contractedNeighbours[edge.to]++;
+			
+			//removes the contracted node from the neighbour's edge list
+			vector<CHEdge>& edges = remaining[edge.to];
+			
+			for(size_t i = 0 ; i < edges.size() ; ++i)
+			{
+				if(edges[i].to == node)
+				{
+					edges[i] = edges.back();
+					edges.pop_back();
+					break ;
+				}
+			}
+		}
+		
+		remaining[node].clear();
+		remaining[node].shrink_to_fit();
+	}
+	
+	return hierarchy;
+}
+
+//Function to find the hierarchy edge between 'from' and 'to' stored at the lower ranked node
+const CHEdge* findCHEdge(const ContractionHierarchy& hierarchy, int from, int to)
+{
+	int lower = hierarchy.rank[from] < hierarchy.rank[to] ? from : to;
+	int higher = lower == from ? to : from;
+	
+	for(const CHEdge& edge : hierarchy.upward[lower])
+	{
+		if(edge.to == higher)
+			return &edge;
+	}
+	
+	return nullptr;
+}
+
+//Function to write the contraction hierarchy to a binary file
+bool saveContractionHierarchy(const ContractionHierarchy& hierarchy, const string& fileName)
+{
+	ofstream file(fileName, ios::binary);
+	
+	if(!file)
+		return false;
+	
+	const char magic[4] = {'C', 'H', '0', '1'};
+	int numOfVertices = hierarchy.rank.size();
+	
+	file.write(magic, sizeof(magic));
+	file.write(reinterpret_cast<const char*>(&numOfVertices), sizeof(numOfVertices));
+	file.write(reinterpret_cast<const char*>(&hierarchy.numShortcuts), sizeof(hierarchy.numShortcuts));
+	file.write(reinterpret_cast<const char*>(hierarchy.rank.data()), numOfVertices * sizeof(int));
+	
+	for(const vector<CHEdge>& edges : hierarchy.upward)
+	{
+		int count = edges.size();
+		file.write(reinterpret_cast<const char*>(&count), sizeof(count));
+		
+		for(const CHEdge& edge : edges)
+		{
+			int fields[3] = {edge.to, edge.weight, edge.middle};
+			file.write(reinterpret_cast<const char*>(fields), sizeof(fields));
+		}
+	}
+	
+	return static_cast<bool>(file);
+}
+
+//Function to read a contraction hierarchy written by saveContractionHierarchy, returns false for a short, corrupt or foreign file
+bool loadContractionHierarchy(const string& fileName, ContractionHierarchy& hierarchy)
+{
+	ifstream file(fileName, ios::binary | ios::ate);
+	char magic[4];
+	int numOfVertices = 0;
+	
+	if(!file)
+		return false;
+	
+	long long fileSize = file.tellg();
+	file.seekg(0);
+	
+	if(!file.read(magic, sizeof(magic)) || string(magic, 4) != "CH01")
+		return false;
+	
+	file.read(reinterpret_cast<char*>(&numOfVertices), sizeof(numOfVertices));
+	file.read(reinterpret_cast<char*>(&hierarchy.numShortcuts), sizeof(hierarchy.numShortcuts));
+	
+	//every station takes at least its rank and its edge count, which bounds what the header may claim before allocating
+	if(!file || numOfVertices < 0 || hierarchy.numShortcuts < 0 || numOfVertices > (fileSize - file.tellg()) / (2 * (long long)sizeof(int)))
+		return false;
+	
+	hierarchy.rank.assign(numOfVertices, -1);
+	hierarchy.upward.assign(numOfVertices, vector<CHEdge>());
+	file.read(reinterpret_cast<char*>(hierarchy.rank.data()), numOfVertices * sizeof(int));
+	
+	//the ranks must be a permutation of 0 .. numOfVertices - 1
+	vector<bool> rankUsed(numOfVertices, false);
+	
+	for(int rank : hierarchy.rank)
+	{
+		if(rank < 0 || rank >= numOfVertices || rankUsed[rank])
+			return false;
+		
+		rankUsed[rank] = true;
+	}
+	
+	for(int v = 0 ; v < numOfVertices ; ++v)
+	{
+		int count = 0;
+		
+		if(!file.read(reinterpret_cast<char*>(&count), sizeof(count)) || count < 0 || count > (fileSize - file.tellg()) / (3 * (long long)sizeof(int)))
+			return false;
+		
+		hierarchy.upward[v].resize(count);
+		
+		for(CHEdge& edge : hierarchy.upward[v])
+		{
+			int fields[3];
+			
+			if(!file.read(reinterpret_cast<char*>(fields), sizeof(fields)))
+				return false;
+			
+			edge = {fields[0], fields[1], fields[2]};
+			
+			//edges lead upwards and a shortcut's middle station was contracted before both of its ends
+			if(edge.to < 0 || edge.to >= numOfVertices || hierarchy.rank[edge.to] <= hierarchy.rank[v] || edge.weight < 0)
+				return false;
+			
+			if(edge.middle < -1 || edge.middle >= numOfVertices || (edge.middle != -1 && hierarchy.rank[edge.middle] >= hierarchy.rank[v]))
+				return false;
+		}
+	}
+	
+	//both halves of every shortcut must be present, so unpacking never runs out of edges
+	for(int v = 0 ; v < numOfVertices ; ++v)
+	{
+		for(const CHEdge& edge : hierarchy.upward[v])
+		{
+			if(edge.middle != -1 && (!findCHEdge(hierarchy, v, edge.middle) || !findCHEdge(hierarchy, edge.middle, edge.to)))
+				return false;
+		}
+	}
+	
+	return true;
+}
+
+//Per-thread state for contraction hierarchy queries, reset in time proportional to the search space
+struct CHQueryState
+{
+	vector<int> forwardDistance, backwardDistance;
+	vector<int> forwardParent, backwardParent;
+	vector<int> touched;
+	
+	explicit CHQueryState(int numOfVertices)
+		: forwardDistance(numOfVertices, numeric_limits<int> :: max()), backwardDistance(numOfVertices, numeric_limits<int> :: max()),
+		  forwardParent(numOfVertices, -1), backwardParent(numOfVertices, -1)
+	{
+	}
+};
+
+//Function to unpack a hierarchy edge into original stations, appends every station after 'from' up to 'to'
+//returns false if the hierarchy is missing an edge a shortcut stands for
+bool unpackCHEdge(const ContractionHierarchy& hierarchy, int from, int to, vector<int>& path)
+{
+	vector<pair<int, int>> stack = {{from, to}};
+	
+	while(!stack.empty())
+	{
+		int a = stack.back().first;
+		int b = stack.back().second;
+		stack.pop_back();
+		
+		const CHEdge* edge = findCHEdge(hierarchy, a, b);
+		
+		if(!edge)
+			return false;
+		
+		if(edge->middle == -1)
+		{
+			path.push_back(b);
+			continue ;
+		}
+		
+		stack.push_back({edge->middle, b});		//pushed in reverse so a -> middle is unpacked first
+		stack.push_back({a, edge->middle});
+	}
+	
+	return true;
+}
+
+//Function to answer a shortest path query with a bidirectional upward search, returns the distance and fills the path
+int queryContractionHierarchy(const ContractionHierarchy& hierarchy, CHQueryState& state, int source, int target, vector<int>& path)
+{
+	for(int node : state.touched)
+	{
+		state.forwardDistance[node] = state.backwardDistance[node] = numeric_limits<int> :: max();
+		state.forwardParent[node] = state.backwardParent[node] = -1;
+	}
+	state.touched.clear();
+	path.clear();
+	
+	typedef priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> MinQueue;
+	MinQueue forward, backward;
+	
+	state.forwardDistance[source] = 0;
+	state.backwardDistance[target] = 0;
+	state.touched.push_back(source);
+	state.touched.push_back(target);
+	forward.push({0, source});
+	backward.push({0, target});
+	
+	int best = numeric_limits<int> :: max();
+	int meeting = -1;
+	
+	//relaxes the upward edges of the next node in one direction of the search
+	auto step = [&](MinQueue& pq, vector<int>& distance, vector<int>& parent, const vector<int>& otherDistance)
+	{
+		int current = pq.top().second ;
+		int currentDistance = pq.top().first ;
+		pq.pop();
+		
+		if(currentDistance > distance[current])
+			return ;
+		
+		if(otherDistance[current] != numeric_limits<int> :: max() && currentDistance + otherDistance[current] < best)
+		{
+			best = currentDistance + otherDistance[current];
+			meeting = current;
+		}
+		
+		for(const CHEdge& edge : hierarchy.upward[current])
+		{
+			int newDistance = currentDistance + edge.weight;
+			
+			if(newDistance < distance[edge.to])
+			{
+				if(state.forwardDistance[edge.to] == numeric_limits<int> :: max() && state.backwardDistance[edge.to] == numeric_limits<int> :: max())
+					state.touched.push_back(edge.to);
+				
+				distance[edge.to] = newDistance;
+				parent[edge.to] = current;
+				pq.push({newDistance, edge.to});
+			}
+		}
+	};
+	
+	while((!forward.empty() && forward.top().first < best) || (!backward.empty() && backward.top().first < best))
+	{
+		if(!forward.empty() && forward.top().first < best)
+			step(forward, state.forwardDistance, state.forwardParent, state.backwardDistance);
+		
+		if(!backward.empty() && backward.top().first < best)
+			step(backward, state.backwardDistance, state.backwardParent, state.forwardDistance);
+	}
+	
+	if(meeting == -1)
+		return numeric_limits<int> :: max();
+	
+	//collects the upward chain from source to the meeting node, then walks down to target
+	vector<int> upChain;
+	
+	for(int node = meeting ; node != -1 ; node = state.forwardParent[node])
+		upChain.push_back(node);
+	
+	reverse(upChain.begin(), upChain.end());
+	path.push_back(source);
+	
+	bool unpacked = true;
+	
+	for(size_t i = 1 ; i < upChain.size() && unpacked ; ++i)
+		unpacked = unpackCHEdge(hierarchy, upChain[i - 1], upChain[i], path);
+	
+	for(int node = meeting ; state.backwardParent[node] != -1 && unpacked ; node = state.backwardParent[node])
+		unpacked = unpackCHEdge(hierarchy, node, state.backwardParent[node], path);
+	
+	//a hierarchy that cannot be unpacked gives no path rather than a partial one
+	if(!unpacked)
+		path.clear();
+	
+	return best;
+}
+
+//Route that collects the treasure of every station it visits, the home station's own treasure is not collected
+struct PrizeRoute
+{
+	vector<int> stations;	//visit order, starting at the home station
+	int distance = 0;
+	int weight = 0;
+	int profit = 0;
+};
+
+//Stations worth visiting and the shortest travel distance between every pair of them, index 0 is the home station
+struct PrizeCandidates
+{
+	vector<int> station;
+	vector<vector<int>> distance;
+};
+
+//Function to keep the stations that fit the capacity and budget on their own, with shortest distances between them
+PrizeCandidates findPrizeCandidates(const RouteGraph& graph, const vector<Station>& stations, int start, int capacity, int budget)
+{
+	PrizeCandidates candidates;
+	int numOfVertices = graph.size();
+	vector<int> fromStart(numOfVertices, numeric_limits<int> :: max()), previous(numOfVertices, -1);
+	DijkstraAlgorithm(graph, start, fromStart, previous);
+	
+	candidates.station.push_back(start);
+	
+	for(int v = 0 ; v < numOfVertices ; ++v)
+	{
+		if(v != start && stations[v].weight <= capacity && stations[v].profit > 0 && fromStart[v] <= budget)
+			candidates.station.push_back(v);
+	}
+	
+	for(int from : candidates.station)
+	{
+		vector<int> distance(graph.size(), numeric_limits<int> :: max());
+		fill(previous.begin(), previous.end(), -1);
+		DijkstraAlgorithm(graph, from, distance, previous);
+		
+		vector<int> row;
+		
+		for(int to : candidates.station)
+			row.push_back(distance[to]);
+		
+		candidates.distance.push_back(row);
+	}
+	
+	return candidates;
+}
+
+//Bitmask DP for small networks - best[mask][last] is the shortest tour from home that collects exactly 'mask' and ends at 'last'
+PrizeRoute planPrizeRouteBitmask(const vector<Station>& stations, const PrizeCandidates& candidates, int capacity, int budget)
+{
+	int start = candidates.station[0];
+	int k = candidates.station.size() - 1;		//candidates other than home, bit j stands for candidate j + 1
+	PrizeRoute route;
+	route.stations.push_back(start);
+	
+	if(k == 0)
+		return route;
+	
+	vector<int> best((size_t(1) << k) * k, numeric_limits<int> :: max());
+	vector<signed char> parent((size_t(1) << k) * k, -1);
+	vector<int> maskWeight(size_t(1) << k, 0), maskProfit(size_t(1) << k, 0);
+	
+	for(size_t mask = 1 ; mask < (size_t(1) << k) ; ++mask)
+	{
+		int low = __builtin_ctzll(mask);
+		maskWeight[mask] = min<long long>(numeric_limits<int> :: max(), (long long)maskWeight[mask & (mask - 1)] + stations[candidates.station[low + 1]].weight);
+		maskProfit[mask] = maskProfit[mask & (mask - 1)] + stations[candidates.station[low + 1]].profit;
+	}
+	
+	for(int j = 0 ; j < k ; ++j)
+		best[(size_t(1) << j) * k + j] = candidates.distance[0][j + 1];
+	
+	size_t bestMask = 0;
+	int bestLast = -1;
+	
+	for(size_t mask = 1 ; mask < (size_t(1) << k) ; ++mask)
+	{
+		if(maskWeight[mask] > capacity)
+			continue ;
+		
+		for(int last = 0 ; last < k ; ++last)
+		{
+			int distance = best[mask * k + last];
+			
+			if(distance > budget)
+				continue ;
+			
+			if(maskProfit[mask] > route.profit || (maskProfit[mask] == route.profit && distance < route.distance))
+			{
+				route.profit = maskProfit[mask];
+				route.distance = distance;
+				bestMask = mask;
+				bestLast = last;
+			}
+			
+			for(int next = 0 ; next < k ; ++next)
+			{
+				size_t nextMask = mask | (size_t(1) << next);
+				int step = candidates.distance[last + 1][next + 1];
+				
+				if(nextMask == mask || step == numeric_limits<int> :: max() || maskWeight[nextMask] > capacity || distance + step > budget)
+					continue ;
+				
+				if(distance + step < best[nextMask * k + next])
+				{
+					best[nextMask * k + next] = distance + step;
+					parent[nextMask * k + next] = last;
+				}
+			}
+		}
+	}
+	
+	//walks the parents back from the best end state
+	vector<int> order;
+	
+	for(size_t mask = bestMask ; bestLast != -1 ; )
+	{
+		order.push_back(candidates.station[bestLast + 1]);
+		int before = parent[mask * k + bestLast];
+		mask &= ~(size_t(1) << bestLast);
+		bestLast = before;
+	}
+	
+	route.stations.insert(route.stations.end(), order.rbegin(), order.rend());
+	route.weight = maskWeight[bestMask];
+	
+	return route;
+}
+
+//Partial route for the label-setting search, its visited bitset is stored in a shared pool at index * words
+struct PrizeLabel
+{
+	int last;
+	int distance, weight, profit;
+	int parent;		//index of the label this one was extended from, -1 for the first hop
+};
+
+//Label-setting for larger networks - the label with the highest bound is extended first, only the shortest label is kept
+//for each last station and set of visited stations, and labels are pruned once their bound cannot beat the best route.
+//New labels are checked against a cheap fractional knapsack bound and settled ones against the exact 0/1 knapsack.
+//Each thread searches the routes starting with a different first hop and they share the best route found.
+PrizeRoute planPrizeRouteLabels(const vector<Station>& stations, const PrizeCandidates& candidates, int capacity, int budget, int numThreads = 0)
+{
+	if(numThreads <= 0)
+		numThreads = max(1u, thread::hardware_concurrency());
+	
+	int start = candidates.station[0];
+	int k = candidates.station.size();
+	int words = (k + 63) / 64;
+	
+	//candidates by profit per unit of weight, used by the fractional bound
+	vector<int> byRatio;
+	
+	for(int j = 1 ; j < k ; ++j)
+		byRatio.push_back(j);
+	
+	sort(byRatio.begin(), byRatio.end(), [&](int a, int b)
+	{
+		return (long long)stations[candidates.station[a]].profit * stations[candidates.station[b]].weight 
+			 > (long long)stations[candidates.station[b]].profit * stations[candidates.station[a]].weight;
+	});
+	
+	auto isSet = [&](const uint64_t* bits, int j) { return bits[j / 64] >> (j % 64) & 1; };
+	
+	//visited candidates plus those the label can no longer reach, by weight or by the shortest distance from its last station
+	auto closedSet = [&](const PrizeLabel& label, const uint64_t* visited, uint64_t* closed)
+	{
+		copy(visited, visited + words, closed);
+		
+		for(int j = 1 ; j < k ; ++j)
+		{
+			if(stations[candidates.station[j]].weight > capacity - label.weight || candidates.distance[label.last][j] > budget - label.distance)
+				closed[j / 64] |= uint64_t(1) << (j % 64);
+		}
+	};
+	
+	//best profit any extension of the label could still reach, ignoring the order of visits and filling the room fractionally
+	auto fractionalBound = [&](const PrizeLabel& label, const uint64_t* closed)
+	{
+		double extra = 0;
+		int room = capacity - label.weight;
+		
+		for(int j : byRatio)
+		{
+			const Station& station = stations[candidates.station[j]];
+			
+			if(isSet(closed, j))
+				continue ;
+			
+			if(station.weight <= room)
+			{
+				room -= station.weight;
+				extra += station.profit;
+			}
+			else
+			{
+				extra += (double)station.profit * room / station.weight;
+				break ;
+			}
+		}
+		
+		return label.profit + extra;
+	};
+	
+	//the same with whole stations only, a 0/1 knapsack over the open candidates - much tighter but a pass over the room per candidate
+	auto knapsackBound = [&](const PrizeLabel& label, const uint64_t* closed, vector<int>& best)
+	{
+		int room = capacity - label.weight;
+		best.assign(room + 1, 0);
+		
+		for(int j = 1 ; j < k ; ++j)
+		{
+			int weight = stations[candidates.station[j]].weight, profit = stations[candidates.station[j]].profit;
+			
+			if(isSet(closed, j))
+				continue ;
+			
+			for(int r = room ; r >= weight ; --r)
+				best[r] = max(best[r], best[r - weight] + profit);
+		}
+		
+		return label.profit + best[room];
+	};
+	
+	//best route so far packed into one key, higher profit first and then shorter distance
+	auto routeKey = [](int profit, int distance) { return (long long)profit << 32 | (numeric_limits<int> :: max() - distance); };
+	atomic<long long> best(routeKey(0, 0));
+	vector<PrizeRoute> threadBest(numThreads);
+	
+	auto bestProfit = [&]() { return int(best.load(memory_order_relaxed) >> 32); };
+	
+	//a label is beaten when no extension can collect more than the best route, or as much along a route no shorter
+	auto beaten = [&](double limit, int distance)
+	{
+		long long key = best.load(memory_order_relaxed);
+		int profit = key >> 32, shortest = numeric_limits<int> :: max() - int(key & 0xffffffff);
+		
+		return limit < profit || (limit <= profit && distance >= shortest);
+	};
+	
+	auto search = [&](int thread)
+	{
+		vector<PrizeLabel> labels;
+		vector<uint64_t> visitedPool;		//words per label, one flat block instead of a vector per label
+		vector<bool> exact;					//whether the queued bound of the label is already the knapsack bound
+		vector<uint64_t> closed(words);
+		vector<int> knapsack;
+		priority_queue<pair<double, int>> pq;		//labels by bound, highest first
+		int bestLabel = -1;
+		
+		auto visited = [&](int index) { return &visitedPool[size_t(index) * words]; };
+		
+		//labels hashed by last station and visited set, so the same stops reached in another order share one entry
+		auto hashStops = [&](int index)
+		{
+			uint64_t hash = labels[index].last;
+			
+			for(int w = 0 ; w < words ; ++w)
+				hash = (hash ^ visited(index)[w]) * 0x9e3779b97f4a7c15ULL;
+			
+			return size_t(hash ^ (hash >> 32));
+		};
+		
+		auto sameStops = [&](int a, int b)
+		{
+			return labels[a].last == labels[b].last && equal(visited(a), visited(a) + words, visited(b));
+		};
+		
+		//open addressed table of the shortest label for each entry, -1 marks a free slot
+		vector<int> kept(1024, -1);
+		size_t numKept = 0;
+		
+		auto slot = [&](int index) -> int&
+		{
+			size_t mask = kept.size() - 1;
+			
+			for(size_t s = hashStops(index) & mask ; ; s = (s + 1) & mask)
+			{
+				if(kept[s] == -1 || sameStops(kept[s], index))
+					return kept[s];
+			}
+		};
+		
+		auto discard = [&]()
+		{
+			labels.pop_back();
+			visitedPool.resize(visitedPool.size() - words);
+		};
+		
+		//the last label in the pool is queued unless its bound is beaten or the same stops were already reached no longer
+		auto push = [&]()
+		{
+			int index = labels.size() - 1;
+			closedSet(labels[index], visited(index), closed.data());
+			double limit = fractionalBound(labels[index], closed.data());
+			
+			if(beaten(limit, labels[index].distance))
+				return discard();
+			
+			int same = slot(index);
+			
+			if(same != -1 && labels[same].distance <= labels[index].distance)
+				return discard();
+			
+			//a longer label with the same stops is replaced, and skipped when popped if it is still queued
+			if(same == -1 && ++numKept * 2 > kept.size())
+			{
+				vector<int> old(kept.size() * 2, -1);		//doubled to stay at most half full
+				old.swap(kept);
+				
+				for(int other : old)
+				{
+					if(other != -1)
+						slot(other) = other;
+				}
+			}
+			
+			slot(index) = index;
+			exact.push_back(false);
+			pq.push({limit, index});
+		};
+		
+		for(int first = 1 + thread ; first < k ; first += numThreads)
+		{
+			labels.push_back({first, candidates.distance[0][first], stations[candidates.station[first]].weight, 
+							  stations[candidates.station[first]].profit, -1});
+			visitedPool.resize(visitedPool.size() + words, 0);
+			visitedPool[visitedPool.size() - words + first / 64] |= uint64_t(1) << (first % 64);
+			push();
+		}
+		
+		while(!pq.empty() && pq.top().first >= bestProfit())
+		{
+			double limit = pq.top().first;
+			int index = pq.top().second;
+			pq.pop();
+			
+			if(slot(index) != index || beaten(limit, labels[index].distance))
+				continue ;
+			
+			PrizeLabel label = labels[index];		//copied, pushing new labels may move the vectors
+			closedSet(label, visited(index), closed.data());
+			
+			//the knapsack bound is worked out once, the label goes back in the queue if it falls below the next one
+			if(!exact[index])
+			{
+				exact[index] = true;
+				limit = knapsackBound(label, closed.data(), knapsack);
+				
+				if(beaten(limit, label.distance))
+					continue ;
+				
+				if(!pq.empty() && limit < pq.top().first)
+				{
+					pq.push({limit, index});
+					continue ;
+				}
+			}
+			
+			if(!beaten(label.profit, label.distance))
+			{
+				bestLabel = index;
+				
+				long long seen = best.load(memory_order_relaxed);
+				long long key = routeKey(label.profit, label.distance);
+				
+				while(key > seen && !best.compare_exchange_weak(seen, key))
+				{
+				}
+			}
+			
+			vector<int> open;		//collected first, push() reuses 'closed'
+			
+			for(int next = 1 ; next < k ; ++next)
+			{
+				if(!isSet(closed.data(), next))
+					open.push_back(next);
+			}
+			
+			for(int next : open)
+			{
+				labels.push_back({next, label.distance + candidates.distance[label.last][next], label.weight + stations[candidates.station[next]].weight, 
+								  label.profit + stations[candidates.station[next]].profit, index});
+				visitedPool.insert(visitedPool.end(), visitedPool.begin() + size_t(index) * words, visitedPool.begin() + size_t(index + 1) * words);
+				visitedPool[visitedPool.size() - words + next / 64] |= uint64_t(1) << (next % 64);
+				push();
+			}
+		}
+		
+		PrizeRoute& route = threadBest[thread];
+		route.stations.push_back(start);
+		
+		if(bestLabel == -1)
+			return ;
+		
+		route.distance = labels[bestLabel].distance;
+		route.weight = labels[bestLabel].weight;
+		route.profit = labels[bestLabel].profit;
+		
+		vector<int> order;
+		
+		for(int index = bestLabel ; index != -1 ; index = labels[index].parent)
+			order.push_back(candidates.station[labels[index].last]);
+		
+		route.stations.insert(route.stations.end(), order.rbegin(), order.rend());
+	};
+	
+	vector<thread> threads;
+	
+	for(int t = 1 ; t < numThreads ; ++t)
+		threads.emplace_back(search, t);
+	
+	search(0);
+	
+	for(thread& worker : threads)
+		worker.join();
+	
+	PrizeRoute route = threadBest[0];
+	
+	for(const PrizeRoute& other : threadBest)
+	{
+		if(other.profit > route.profit || (other.profit == route.profit && other.distance < route.distance))
+			route = other;
+	}
+	
+	return route;
+}
+
+//Function to plan the most profitable route within the weight capacity and travel budget,
+//exact bitmask DP while at most 20 stations qualify and label-setting beyond that
+PrizeRoute planPrizeRoute(const RouteGraph& graph, const vector<Station>& stations, int start, int capacity, int budget, int numThreads = 0)
+{
+	const int bitmaskLimit = 20;
+	PrizeCandidates candidates = findPrizeCandidates(graph, stations, start, capacity, budget);
+	
+	if(candidates.station.size() - 1 <= bitmaskLimit)
+		return planPrizeRouteBitmask(stations, candidates, capacity, budget);
+	
+	return planPrizeRouteLabels(stations, candidates, capacity, budget, numThreads);
+}
+
+//Latency histogram with power of two buckets in microseconds
+struct LatencyHistogram
+{
+	vector<long long> counts = vector<long long>(32, 0);
+	long long total = 0;
+	
+	void record(long long microseconds)
+	{
+		int bucket = 0;
+		
+		while(bucket < 31 && (1LL << bucket) <= microseconds)
+			bucket++;
+		
+		counts[bucket]++;
+		total++;
+	}
+	
+	//upper bound of the bucket holding the given fraction of all queries
+	long long percentile(double fraction) const
+	{
+		long long seen = 0;
+		
+		for(int bucket = 0 ; bucket < 32 ; ++bucket)
+		{
+			seen += counts[bucket];
+			
+			if(seen > 0 && seen >= fraction * total)
+				return 1LL << bucket;
+		}
+		
+		return 0;
+	}
+};
+
+//Function to answer one "source target" query, writes "OK source target distance path..." or an error line
+void answerQuery(const ContractionHierarchy& hierarchy, CHQueryState& state, const string& line, OutputBuffer& out, LatencyHistogram& latency)
+{
+	auto startTime = chrono::steady_clock::now();
+	istringstream fields(line);
+	int source, target;
+	vector<int> path;
+	int numOfVertices = hierarchy.rank.size();
+	
+	if(!(fields >> source >> target) || source < 0 || target < 0 || source >= numOfVertices || target >= numOfVertices)
+	{
+		out << "ERR invalid station\n";
+		return ;
+	}
+	
+	int distance = queryContractionHierarchy(hierarchy, state, source, target, path);
+	
+	out << "OK " << source << ' ' << target << ' ';
+	
+	if(distance == numeric_limits<int> :: max())
+	{
+		out << "-1\n";
+	}
+	else
+	{
+		out << distance;
+		
+		for(int station : path)
+			out << ' ' << station;
+		
+		out << '\n';
+	}
+	
+	latency.record(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - startTime).count());
+}
+
+//Query server - queries are answered from a line protocol on a contraction hierarchy built or loaded beforehand
+//  QUERY s t       shortest distance and path from s to t
+//  BATCH n         followed by n lines of "s t", answered in order
+//  STATS           query count and latency percentiles in microseconds
+//  QUIT            stops the server
+//Responses are buffered while more input is already waiting, so pipelined requests are answered in blocks
+int runQueryServer(const ContractionHierarchy& hierarchy, istream& in, ostream& output)
+{
+	CHQueryState state(hierarchy.rank.size());
+	LatencyHistogram latency;
+	OutputBuffer out(output);
+	string line;
+	
+	out << "READY " << static_cast<int>(hierarchy.rank.size()) << '\n';
+	out.flush();
+	output.flush();
+	
+	while(getline(in, line))
+	{
+		istringstream fields(line);
+		string command;
+		fields >> command;
+		
+		if(command == "QUERY")
+		{
+			string rest;
+			getline(fields, rest);
+			answerQuery(hierarchy, state, rest, out, latency);
+		}
+		else if(command == "BATCH")
+		{
+			int count = 0;
+			fields >> count;
+			
+			for(int i = 0 ; i < count && getline(in, line) ; ++i)
+				answerQuery(hierarchy, state, line, out, latency);
+		}
+		else if(command == "STATS")
+		{
+			out << "STATS queries=" << latency.total << " p50<=" << latency.percentile(0.5) << "us p90<=" << latency.percentile(0.9) 
+				<< "us p99<=" << latency.percentile(0.99) << "us histogram";
+			
+			for(int bucket = 0 ; bucket < 32 ; ++bucket)
+			{
+				if(latency.counts[bucket] > 0)
+					out << ' ' << "<=" << (1LL << bucket) << "us:" << latency.counts[bucket];
+			}
+			
+			out << '\n';
+		}
+		else if(command == "QUIT")
+		{
+			break ;
+		}
+		else if(!command.empty())
+		{
+			out << "ERR unknown command\n";
+		}
+		
+		if(in.rdbuf()->in_avail() <= 0)		//nothing else pipelined, so the client is waiting for answers
+		{
+			out.flush();
+			output.flush();
+		}
+	}
+	
+	out.flush();
+	output.flush();
+	return 0;
+}
+
+int main(int argc, char* argv[]) 
+{
+    long long seedSum = 1201100116LL + 1201201773LL + 1201201862LL;
+    vector<int> seedDigits;
+    long long tempSeedSum = seedSum;
+    
+	while (tempSeedSum > 0) 
+	{
+        seedDigits.push_back(tempSeedSum % 10);
+        tempSeedSum /= 10;
+    }
+    reverse(seedDigits.begin(), seedDigits.end());
+
+    vector<Station> stations = generateStations(static_cast<unsigned int>(seedSum), 20, seedDigits);
+    vector<pair<int, int>> routes = generateRoutes(stations, 54);
+    
+    //Server mode - answers queries on stdin/stdout from a saved hierarchy file, or from one built here when no file is given
+    if(argc > 1 && string(argv[1]) == "--serve")
+    {
+    	ContractionHierarchy hierarchy;
+    	
+    	if(argc > 2 && !loadContractionHierarchy(argv[2], hierarchy))
+    	{
+    		cerr << "Error: could not read contraction hierarchy from " << argv[2] << endl;
+    		return 1;
+		}
+		
+		if(argc <= 2)
+			hierarchy = buildContractionHierarchy(buildGraph(stations, routes));
+		
+    	ios::sync_with_stdio(false);
+    	return runQueryServer(hierarchy, cin, cout);
+	}
+
+    for (const Station& station : stations) 
+	{
+        cout << station.name << " "
+                  << station.x << " "
+                  << station.y << " "
+                  << station.z << " "
+                  << station.weight << " "
+                  << station.profit << endl;
+    }
+    
+    cout << endl ;
+
+    for (const auto& route : routes) 
+	{
+        cout << "Route between " << stations[route.first].name
+                  << " (" << route.first << ")"
+                  << " and " << stations[route.second].name
+                  << " (" << route.second << ")"
+                  << " Distance: " << calculateDistance(stations[route.first], stations[route.second])
+                  << endl;
+    }
+    
+    GraphArena arena(estimateGraphArenaBytes(stations.size(), routes.size()));
+    RouteGraph graph = buildGraph(stations, routes, &arena.resource);
+	
+	int startStation = 0 ;
+	
+	vector<int> distance(stations.size(), numeric_limits<int> :: max());
+	vector<int> previous(stations.size(), -1);
+	
+	DijkstraAlgorithm(graph, startStation, distance, previous);
+	
+	cout << endl ;
+	
+	//print Shortest Path
+	shortestPath(distance, previous, startStation);
+	
+	// Generate Graphviz DOT file
+    graphShortestPath(stations, routes, previous);
+
+    // Inform the user
+    cout << "Graphviz DOT file generated: shortestPathGraph.dot" << endl;
+    
+    // Compact dumps of the shortest path tree
+    if(!writeShortestPathCSV(distance, previous, "shortestPathTree.csv") || !writeShortestPathBinary(distance, previous, "shortestPathTree.bin"))
+    {
+    	cerr << "Error: could not write the shortest path tree dumps" << endl;
+    	return 1;
+	}
+    
+    cout << "Shortest path tree written to shortestPathTree.csv and shortestPathTree.bin" << endl;
+    
+    //Contraction hierarchy, preprocessed once and then queried point to point
+    ContractionHierarchy hierarchy = buildContractionHierarchy(graph);
+    ContractionHierarchy loadedHierarchy;
+    
+    if(!saveContractionHierarchy(hierarchy, "contractionHierarchy.bin") || !loadContractionHierarchy("contractionHierarchy.bin", loadedHierarchy))
+    {
+    	cerr << "Error: could not write or read contractionHierarchy.bin" << endl;
+    	return 1;
+	}
+    
+    int numOfStations = stations.size();
+    CHQueryState queryState(numOfStations);
+    vector<int> path;
+    
+    for(int i = 0 ; i < numOfStations ; ++i)
+    {
+    	if(queryContractionHierarchy(loadedHierarchy, queryState, startStation, i, path) != distance[i])
+    	{
+    		cerr << "Error: contraction hierarchy distance to Station " << i << " differs from Dijkstra" << endl;
+    		return 1;
+		}
+	}
+    
+    cout << "Contraction hierarchy with " << loadedHierarchy.numShortcuts << " shortcuts matches Dijkstra for all stations" << endl;
+    
+    //Delta-stepping on the same graph, cross-checked against Dijkstra
+    vector<int> deltaDistance(stations.size(), numeric_limits<int> :: max());
+    vector<int> deltaPrevious(stations.size(), -1);
+    
+    DeltaSteppingAlgorithm(graph, startStation, deltaDistance, deltaPrevious);
+    
+    if(deltaDistance != distance)
+    {
+    	cerr << "Error: delta-stepping distances differ from Dijkstra" << endl;
+    	return 1;
+	}
+    
+    cout << "Delta-stepping distances match Dijkstra for all stations" << endl;
+
+    //Same search on the stations relabelled for locality, with the answers mapped back to the original ids
+    for(const VertexOrder& order : {cuthillMcKeeOrder(graph), hilbertOrder(stations)})
+    {
+    	RouteGraph reorderedGraph = reorderGraph(graph, order);
+    	vector<int> reorderedDistance(stations.size(), numeric_limits<int> :: max());
+    	vector<int> reorderedPrevious(stations.size(), -1);
+
+    	DijkstraAlgorithm(reorderedGraph, order.newId[startStation], reorderedDistance, reorderedPrevious);
+    	restoreVertexIds(order, reorderedDistance, reorderedPrevious);
+
+    	if(reorderedDistance != distance)
+    	{
+    		cerr << "Error: Dijkstra on the relabelled graph differs from the original labelling" << endl;
+    		return 1;
+		}
+	}
+
+    cout << "Dijkstra on the Cuthill-McKee and Hilbert relabelled graphs matches the original labelling" << endl;
+
+    //Dynamic mode - closes and reopens the first route, repairing only the affected part of the tree
+    DynamicShortestPaths dynamicPaths = initDynamicShortestPaths(graph, startStation);
+    int a = routes[0].first;
+    int b = routes[0].second;
+    int routeDistance = calculateDistance(stations[a], stations[b]);
+    
+    int changedOnRemove = removeRoute(dynamicPaths, a, b);
+    int changedOnInsert = updateRoute(dynamicPaths, a, b, routeDistance);
+    
+    if(dynamicPaths.distance != distance)
+    {
+    	cerr << "Error: dynamic shortest paths differ from Dijkstra after reopening a route" << endl;
+    	return 1;
+	}
+    
+    cout << "Closing and reopening route " << a << " -- " << b << " updated " << changedOnRemove 
+    	 << " and " << changedOnInsert << " stations" << endl;
+    
+    //Most profitable treasure route from the start station within a weight capacity and travel budget
+    int capacity = 200;
+    int travelBudget = 2000;
+    PrizeCandidates candidates = findPrizeCandidates(graph, stations, startStation, capacity, travelBudget);
+    PrizeRoute prizeRoute = planPrizeRoute(graph, stations, startStation, capacity, travelBudget);
+    
+    if(planPrizeRouteLabels(stations, candidates, capacity, travelBudget).profit != prizeRoute.profit)
+    {
+    	cerr << "Error: label-setting and bitmask route planners disagree" << endl;
+    	return 1;
+	}
+    
+    cout << "Treasure route within " << capacity << " weight and " << travelBudget << " distance : ";
+    
+    for(int station : prizeRoute.stations)
+    	cout << stations[station].name << " ";
+    
+    cout << "(profit " << prizeRoute.profit << ", weight " << prizeRoute.weight << ", distance " << prizeRoute.distance << ")" << endl;
+
+    //Network just above the bitmask limit, where planPrizeRoute switches to label-setting - the search has to stay quick
+    vector<Station> largerStations = generateStations(static_cast<unsigned int>(seedSum), 22, seedDigits);
+    RouteGraph largerGraph = buildGraph(largerStations, generateRoutes(largerStations, 60));
+    int largerCapacity = 400;
+    int largerBudget = 4000;
+    int numOfCandidates = findPrizeCandidates(largerGraph, largerStations, startStation, largerCapacity, largerBudget).station.size() - 1;
+
+    auto planStart = chrono::steady_clock::now();
+    PrizeRoute largerRoute = planPrizeRoute(largerGraph, largerStations, startStation, largerCapacity, largerBudget);
+    double planSeconds = chrono::duration<double>(chrono::steady_clock::now() - planStart).count();
+
+    if(largerRoute.weight > largerCapacity || largerRoute.distance > largerBudget)
+    {
+    	cerr << "Error: treasure route on " << largerStations.size() << " stations breaks the capacity or budget" << endl;
+    	return 1;
+	}
+
+    if(planSeconds > 10)
+    {
+    	cerr << "Error: treasure route over " << numOfCandidates << " candidates took " << planSeconds << " s to plan" << endl;
+    	return 1;
+	}
+
+    cout << "Treasure route over " << numOfCandidates << " candidates planned in " << planSeconds << " s (profit " << largerRoute.profit << ")" << endl;
+
+    return 0;
+}
+
+
+/*
+HOW TO RUN THE GRAPH : USING COMMAND PROMPT
+C:\Users\Elyana>E:
+
+E:\>cd "MMU Degree\Sem4\Algorithm Design Analysis\Assignment\Q3"
+
+E:\MMU Degree\Sem4\Algorithm Design Analysis\Assignment\Q3>dot -Tpng shortestPathGraph.dot -o shortestPathGraph.png
+
+E:\MMU Degree\Sem4\Algorithm Design Analysis\Assignment\Q3>
+*/
+
+/*
+HOW TO RUN THE QUERY SERVER : USING COMMAND PROMPT
+E:\MMU Degree\Sem4\Algorithm Design Analysis\Assignment\Q3>DijkstraAlgorithm.exe --serve
+READY 20
+QUERY 0 5
+OK 0 5 727 0 5
+STATS
+QUIT
+
+E:\MMU Degree\Sem4\Algorithm Design Analysis\Assignment\Q3>DijkstraAlgorithm.exe --serve contractionHierarchy.bin
+READY 20
+QUERY 0 5
+OK 0 5 727 0 5
+QUIT
 */
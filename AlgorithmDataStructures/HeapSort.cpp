@@ -4,6 +4,7 @@
 #include <chrono>
 #include <algorithm>
 #include "matplotlibcpp.h"
+#include "Instrumentation.h"
 
 #ifndef MATPLOTLIBCPP_H
 #define MATPLOTLIBCPP_H
@@ -54,6 +55,7 @@ void heapify(std::vector<int>& arr, int n, int i) {
         largest = right;
 
     if (largest != i) {
+        INSTRUMENT_COUNT("heapify.siftDownSteps", 1);
         std::swap(arr[i], arr[largest]);
         heapify(arr, n, largest);
     }
@@ -61,6 +63,7 @@ void heapify(std::vector<int>& arr, int n, int i) {
 
 // Function to perform Heap Sort and measure time
 void heapSort(std::vector<int>& arr, std::vector<long long>& timings) {
+    INSTRUMENT_PHASE("heapSort");
     auto start_time = std::chrono::high_resolution_clock::now();
 
     int n = arr.size();
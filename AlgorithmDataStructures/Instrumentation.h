@@ -0,0 +1,151 @@
+#ifndef INSTRUMENTATION_H
+#define INSTRUMENTATION_H
+
+// Hot-path counters and phase timers, switched on at compile time with -DENABLE_INSTRUMENTATION.
+//
+//   INSTRUMENT_COUNT("dijkstra.relaxations", 1);   adds to a named counter of the calling thread
+//   INSTRUMENT_PHASE("dijkstra");                  times the enclosing scope
+//
+// Every thread counts into its own thread_local block, which is folded into the totals when the thread ends.
+// A report is written to stderr at exit, or to the file named by the INSTRUMENTATION_REPORT environment variable.
+// When the switch is off both macros expand to nothing, so their arguments are not even evaluated.
+
+#ifdef ENABLE_INSTRUMENTATION
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace instrumentation
+{
+    // Names and totals shared by all threads, the report is printed when it is destroyed at exit
+    struct Registry
+    {
+        std::mutex lock;
+        std::vector<std::string> counterNames, phaseNames;
+        std::vector<long long> counterTotals, phaseCalls;
+        std::vector<double> phaseSeconds;
+
+        ~Registry()
+        {
+            const char* path = std::getenv("INSTRUMENTATION_REPORT");
+            FILE* out = path ? std::fopen(path, "w") : stderr;
+            if (!out)
+                out = stderr;
+
+            std::fprintf(out, "{\"counters\": {");
+            for (size_t i = 0; i < counterNames.size(); ++i)
+                std::fprintf(out, "%s\"%s\": %lld", i ? ", " : "", counterNames[i].c_str(), counterTotals[i]);
+
+            std::fprintf(out, "}, \"phases\": {");
+            for (size_t i = 0; i < phaseNames.size(); ++i)
+                std::fprintf(out, "%s\"%s\": {\"calls\": %lld, \"seconds\": %.6f}", i ? ", " : "", phaseNames[i].c_str(), phaseCalls[i], phaseSeconds[i]);
+
+            std::fprintf(out, "}}\n");
+            if (out != stderr)
+                std::fclose(out);
+        }
+    };
+
+    inline Registry& registry()
+    {
+        static Registry instance;
+        return instance;
+    }
+
+    inline int registerName(std::vector<std::string>& names, const char* name)
+    {
+        Registry& r = registry();
+        std::lock_guard<std::mutex> guard(r.lock);
+        for (size_t i = 0; i < names.size(); ++i)
+            if (names[i] == name)
+                return i;
+
+        names.push_back(name);
+        r.counterTotals.resize(r.counterNames.size());
+        r.phaseCalls.resize(r.phaseNames.size());
+        r.phaseSeconds.resize(r.phaseNames.size());
+        return names.size() - 1;
+    }
+
+    inline int registerCounter(const char* name) { return registerName(registry().counterNames, name); }
+    inline int registerPhase(const char* name) { return registerName(registry().phaseNames, name); }
+
+    // Per-thread block, merged into the registry when the thread exits
+    struct ThreadCounters
+    {
+        std::vector<long long> counts, calls;
+        std::vector<double> seconds;
+
+        ThreadCounters() { registry(); }  // makes sure the registry outlives this block
+
+        ~ThreadCounters()
+        {
+            Registry& r = registry();
+            std::lock_guard<std::mutex> guard(r.lock);
+            for (size_t i = 0; i < counts.size(); ++i)
+                r.counterTotals[i] += counts[i];
+            for (size_t i = 0; i < calls.size(); ++i)
+            {
+                r.phaseCalls[i] += calls[i];
+                r.phaseSeconds[i] += seconds[i];
+            }
+        }
+    };
+
+    inline ThreadCounters& local()
+    {
+        thread_local ThreadCounters counters;
+        return counters;
+    }
+
+    inline void count(int id, long long amount)
+    {
+        std::vector<long long>& counts = local().counts;
+        if (id >= (int)counts.size())
+            counts.resize(id + 1, 0);
+        counts[id] += amount;
+    }
+
+    struct ScopedPhase
+    {
+        int id;
+        std::chrono::steady_clock::time_point start;
+
+        explicit ScopedPhase(int phase) : id(phase), start(std::chrono::steady_clock::now()) {}
+
+        ~ScopedPhase()
+        {
+            ThreadCounters& counters = local();
+            if (id >= (int)counters.calls.size())
+            {
+                counters.calls.resize(id + 1, 0);
+                counters.seconds.resize(id + 1, 0);
+            }
+            counters.calls[id]++;
+            counters.seconds[id] += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        }
+    };
+}
+
+#define INSTRUMENT_CONCAT_INNER(a, b) a##b
+#define INSTRUMENT_CONCAT(a, b) INSTRUMENT_CONCAT_INNER(a, b)
+
+#define INSTRUMENT_COUNT(name, amount) \
+    do { static const int instrumentId = instrumentation::registerCounter(name); instrumentation::count(instrumentId, (amount)); } while (0)
+
+#define INSTRUMENT_PHASE(name) \
+    static const int INSTRUMENT_CONCAT(instrumentPhaseId, __LINE__) = instrumentation::registerPhase(name); \
+    instrumentation::ScopedPhase INSTRUMENT_CONCAT(instrumentPhase, __LINE__)(INSTRUMENT_CONCAT(instrumentPhaseId, __LINE__))
+
+#else
+
+#define INSTRUMENT_COUNT(name, amount) do { } while (0)
+#define INSTRUMENT_PHASE(name) do { } while (0)
+
+#endif
+
+#endif // INSTRUMENTATION_H
@@ -7,6 +7,14 @@
 #include <map>
 #include <iterator>
 #include <fstream>
+#include <memory_resource>
+#include <thread>
+#include <atomic>
+#include <memory>
+#include <limits>
+#include <array>
+#include <cstdint>
+#include "Instrumentation.h"
 
 using namespace std;
 
@@ -72,13 +80,20 @@ vector<Station> generateStations(unsigned int seed, int numStations, const vecto
 }
 
 
-// Function to generate a map of connections between stations
-vector<pair<int, int>> generateRoutes(const vector<Station>& stations, int numRoutes) 
+//Function to size the scratch block of generateRoutes, set and map nodes are about 48 bytes - one per station, three per route
+size_t estimateRouteScratchBytes(int numStations, int numRoutes) 
+{
+    return size_t(numStations) * 2 * 48 + size_t(numRoutes) * 3 * 48;
+}
+
+// Function to generate a map of connections between stations, the temporary sets live in a scratch block taken from 'upstream' and released on return
+vector<pair<int, int>> generateRoutes(const vector<Station>& stations, int numRoutes, pmr::memory_resource* upstream = pmr::get_default_resource()) 
 {
     vector<pair<int, int>> routes;
-    set<pair<int, int>> uniqueRoutes;
+    pmr::monotonic_buffer_resource scratch(estimateRouteScratchBytes(stations.size(), numRoutes), upstream);
+    pmr::set<pair<int, int>> uniqueRoutes(&scratch);
     mt19937 rng(random_device{}());
-    map<int, set<int>> connections;
+    pmr::map<int, pmr::set<int>> connections(&scratch);
 
     // Ensure all stations have at least 3 connections
     for (int i = 0; i < stations.size(); ++i) 
@@ -99,103 +114,1379 @@ vector<pair<int, int>> generateRoutes(const vector<Station>& stations, int numRo
     // Add additional unique routes until we reach 54
     while (uniqueRoutes.size() < numRoutes) 
 	{
-        int a = rng() % stations.size();
-        int b = rng() % stations.size();
-        
-		if (a != b && uniqueRoutes.find(minmax(a, b)) == uniqueRoutes.end()) 
+        int a = rng() % stations.size();
+        int b = rng() % stations.size();
+        
+		if (a != b && uniqueRoutes.find(minmax(a, b)) == uniqueRoutes.end()) 
+		{
+            uniqueRoutes.insert(minmax(a, b));
+            connections[a].insert(b);
+            connections[b].insert(a);
+        }
+    }
+
+    // Transfer unique routes to the vector
+    routes.reserve(uniqueRoutes.size());
+    for (const auto& route : uniqueRoutes) 
+	{
+        routes.emplace_back(route);
+    }
+
+    return routes;
+}
+
+//Structure for edge between two stations
+struct Edge			
+{
+	int u, v;
+	double distance;
+	
+	Edge(int x, int y, double dist) 
+	{
+		u = x ;
+		v = y ;
+		distance = dist ;
+	}
+};
+
+bool comp(const Edge &a, const Edge &b)
+{
+	return a.distance < b.distance ;
+}
+
+//Disjoint set - one packed array, a root holds minus the size of its set and every other element holds its parent
+struct DisjointSet
+{
+	vector<int> parent;
+	int numOfSets;
+	
+	explicit DisjointSet(int numOfElements) : parent(numOfElements, -1), numOfSets(numOfElements)
+	{
+	}
+	
+	//find function - to determine root of set, iterative with path halving so deep chains cannot overflow the stack
+	int find(int u)
+	{
+		INSTRUMENT_COUNT("find.calls", 1);
+		
+		while(parent[u] >= 0)
+		{
+			INSTRUMENT_COUNT("find.pathLength", 1);
+			int next = parent[u];
+			
+			if(parent[next] < 0)
+				return next;
+			
+			parent[u] = parent[next];		//point u to its grandparent and continue from there
+			u = parent[u];
+		}
+		
+		return u;
+	}
+	
+	//union function - perform union by size of two sets, returns false if they were already the same set
+	bool unite(int u, int v)
+	{
+		u = find(u);
+		v = find(v);
+		
+		if(u == v)
+			return false;
+		
+		if(parent[u] > parent[v])		//keeps u as the larger set
+			swap(u, v);
+		
+		parent[u] += parent[v];
+		parent[v] = u;
+		numOfSets--;
+		
+		return true;
+	}
+	
+	//read-only root lookup without path halving, so many threads may call it while nothing unites
+	int root(int u) const
+	{
+		while(parent[u] >= 0)
+			u = parent[u];
+		
+		return u;
+	}
+	
+	bool connected(int u, int v)
+	{
+		return find(u) == find(v);
+	}
+	
+	int setSize(int u)
+	{
+		return -parent[find(u)];
+	}
+};
+
+vector<Edge> KruskalsAlgorithm (const vector<Edge> &edges, int numOfVertices)
+{
+	INSTRUMENT_PHASE("kruskal");
+	vector<Edge> minimumSpanningTree;
+	
+	DisjointSet components(numOfVertices);
+	
+	//sort edges in non-decreasing order of distance
+	vector<Edge> sortedEdges = edges ;
+	sort(sortedEdges.begin(), sortedEdges.end(), comp);
+	
+	for(const Edge &edge : sortedEdges)
+	{		
+		if(components.unite(edge.u, edge.v))
+		{
+			minimumSpanningTree.push_back(edge);
+			
+			if(components.numOfSets == 1)		//tree is complete, remaining edges would all be rejected
+				break ;
+		}
+	}
+	
+	return minimumSpanningTree ;
+} 
+
+//Function to sort edges with several threads - chunks are sorted in parallel and then merged pairwise
+void parallelSortEdges(vector<Edge>::iterator begin, vector<Edge>::iterator end, int numThreads)
+{
+	long long size = end - begin;
+	const long long minPerThread = 1 << 15;
+	int chunks = min<long long>(numThreads, size / minPerThread);
+	
+	if(chunks <= 1)
+	{
+		sort(begin, end, comp);
+		return ;
+	}
+	
+	vector<vector<Edge>::iterator> bounds;
+	
+	for(int i = 0 ; i <= chunks ; ++i)
+		bounds.push_back(begin + size * i / chunks);
+	
+	vector<thread> threads;
+	
+	for(int i = 0 ; i < chunks ; ++i)
+		threads.emplace_back([&bounds, i]() { sort(bounds[i], bounds[i + 1], comp); });
+	
+	for(thread& worker : threads)
+		worker.join();
+	
+	//merges neighbouring sorted runs, every level halves the number of runs
+	for(int width = 1 ; width < chunks ; width *= 2)
+	{
+		threads.clear();
+		
+		for(int i = 0 ; i + width < chunks ; i += 2 * width)
+		{
+			auto first = bounds[i], middle = bounds[i + width], last = bounds[min(i + 2 * width, chunks)];
+			threads.emplace_back([first, middle, last]() { inplace_merge(first, middle, last, comp); });
+		}
+		
+		for(thread& worker : threads)
+			worker.join();
+	}
+}
+
+//Function to run Filter-Kruskal on edges[begin, end), light edges are handled before heavy edges are filtered
+void filterKruskal(vector<Edge>& edges, size_t begin, size_t end, DisjointSet& components, vector<Edge>& minimumSpanningTree, int numThreads, mt19937& rng)
+{
+	if(begin >= end || components.numOfSets == 1)
+		return ;
+	
+	const size_t baseSize = 1 << 12;
+	
+	if(end - begin <= max<size_t>(baseSize, components.parent.size()))		//small enough for plain Kruskal
+	{
+		parallelSortEdges(edges.begin() + begin, edges.begin() + end, numThreads);
+		
+		for(size_t i = begin ; i < end && components.numOfSets > 1 ; ++i)
+		{
+			if(components.unite(edges[i].u, edges[i].v))
+				minimumSpanningTree.push_back(edges[i]);
+		}
+		
+		return ;
+	}
+	
+	//median of three random distances as the pivot
+	double sample[3];
+	
+	for(double& distance : sample)
+		distance = edges[begin + rng() % (end - begin)].distance;
+	
+	sort(sample, sample + 3);
+	double pivot = sample[1];
+	
+	auto first = edges.begin() + begin, last = edges.begin() + end;
+	auto middle = partition(first, last, [pivot](const Edge& edge) { return edge.distance < pivot; });
+	
+	if(middle == first)		//pivot is the minimum, so take the edges equal to it as the light half
+		middle = partition(first, last, [pivot](const Edge& edge) { return edge.distance <= pivot; });
+	
+	if(middle == last)		//every edge has the same distance, so any order is already sorted
+	{
+		for(size_t i = begin ; i < end && components.numOfSets > 1 ; ++i)
+		{
+			if(components.unite(edges[i].u, edges[i].v))
+				minimumSpanningTree.push_back(edges[i]);
+		}
+		
+		return ;
+	}
+	
+	size_t split = middle - edges.begin();
+	filterKruskal(edges, begin, split, components, minimumSpanningTree, numThreads, rng);
+	
+	//filter - heavy edges inside one component can never join the tree
+	auto kept = remove_if(middle, last, [&components](const Edge& edge) { return components.connected(edge.u, edge.v); });
+	
+	filterKruskal(edges, split, kept - edges.begin(), components, minimumSpanningTree, numThreads, rng);
+}
+
+//Filter-Kruskal - gives the same tree weight as KruskalsAlgorithm without fully sorting every edge
+vector<Edge> FilterKruskalAlgorithm(const vector<Edge> &edges, int numOfVertices, int numThreads = 0)
+{
+	if(numThreads <= 0)
+		numThreads = max(1u, thread::hardware_concurrency());
+	
+	vector<Edge> minimumSpanningTree;
+	vector<Edge> workEdges = edges;
+	DisjointSet components(numOfVertices);
+	mt19937 rng(numOfVertices);
+	
+	filterKruskal(workEdges, 0, workEdges.size(), components, minimumSpanningTree, numThreads, rng);
+	
+	return minimumSpanningTree;
+}
+
+//Function to split [0, count) into one block per thread and run body(begin, end) on each block
+//Function to pick the number of threads for 'count' items, each thread gets at least 16k of them
+int parallelWorkers(size_t count, int numThreads)
+{
+	const size_t minPerThread = 1 << 14;
+	return max<int>(1, min<size_t>(numThreads, count / minPerThread));
+}
+
+//Function to run body(slice, begin, end) on 'workers' equal slices of [0, count), the calling thread takes slice 0
+template <typename Function>
+void parallelSlices(size_t count, int workers, Function body)
+{
+	vector<thread> threads;
+	
+	for(int t = 1 ; t < workers ; ++t)
+		threads.emplace_back(body, t, count * t / workers, count * (t + 1) / workers);
+	
+	body(0, size_t(0), count / workers);
+	
+	for(thread& worker : threads)
+		worker.join();
+}
+
+template <typename Function>
+void parallelFor(size_t count, int numThreads, Function body)
+{
+	parallelSlices(count, parallelWorkers(count, numThreads), [&](int, size_t begin, size_t end) { body(begin, end); });
+}
+
+//Edge still crossing two components during Boruvka, a and b are the current components of its end points
+struct BoruvkaEdge
+{
+	int a, b;
+	int index;
+};
+
+//Boruvka's Algorithm - every round each component picks its lightest outgoing edge in parallel, then components are merged
+vector<Edge> BoruvkaAlgorithm(const vector<Edge> &edges, int numOfVertices, int numThreads = 0)
+{
+	if(numThreads <= 0)
+		numThreads = max(1u, thread::hardware_concurrency());
+	
+	vector<Edge> minimumSpanningTree;
+	DisjointSet components(numOfVertices);
+	vector<BoruvkaEdge> remaining, compacted;		//edges that still join two components
+	vector<int> live(numOfVertices);				//roots of the current components
+	unique_ptr<atomic<long long>[]> cheapest(new atomic<long long>[numOfVertices]);
+	
+	for(int i = 0 ; i < numOfVertices ; ++i)
+		live[i] = i;
+	
+	for(size_t i = 0 ; i < edges.size() ; ++i)
+	{
+		if(edges[i].u != edges[i].v)
+			remaining.push_back({edges[i].u, edges[i].v, int(i)});
+	}
+	
+	//edges are ordered by distance and then by index, so ties can never close a cycle
+	auto lighter = [&edges](long long a, long long b)
+	{
+		return edges[a].distance < edges[b].distance || (edges[a].distance == edges[b].distance && a < b);
+	};
+	
+	//lock-free minimum - retries until the stored edge is no heavier than the offered one
+	auto offer = [&](int component, long long index)
+	{
+		long long current = cheapest[component].load(memory_order_relaxed);
+		
+		while(current == -1 || lighter(index, current))
+		{
+			if(cheapest[component].compare_exchange_weak(current, index, memory_order_relaxed))
+				break ;
+		}
+	};
+	
+	while(!remaining.empty() && components.numOfSets > 1)
+	{
+		parallelFor(live.size(), numThreads, [&](size_t begin, size_t end)
+		{
+			for(size_t i = begin ; i < end ; ++i)
+				cheapest[live[i]].store(-1, memory_order_relaxed);
+		});
+		
+		parallelFor(remaining.size(), numThreads, [&](size_t begin, size_t end)
+		{
+			for(size_t i = begin ; i < end ; ++i)
+			{
+				offer(remaining[i].a, remaining[i].index);
+				offer(remaining[i].b, remaining[i].index);
+			}
+		});
+		
+		//merges along the chosen edges, an edge picked by both of its components is added once
+		for(int component : live)
+		{
+			long long index = cheapest[component].load(memory_order_relaxed);
+			
+			if(index != -1 && components.unite(edges[index].u, edges[index].v))
+				minimumSpanningTree.push_back(edges[index]);
+		}
+		
+		live.erase(remove_if(live.begin(), live.end(), [&](int component) { return components.parent[component] >= 0; }), live.end());
+		
+		//moves every edge to its new components and drops the ones now inside a component -
+		//each slice compacts in place, then the slices are copied to their prefix-sum offsets
+		int workers = parallelWorkers(remaining.size(), numThreads);
+		vector<size_t> offset(workers + 1, 0);
+		
+		parallelSlices(remaining.size(), workers, [&](int slice, size_t begin, size_t end)
+		{
+			size_t kept = begin;
+			
+			for(size_t i = begin ; i < end ; ++i)
+			{
+				int a = components.root(remaining[i].a);
+				int b = components.root(remaining[i].b);
+				
+				if(a != b)
+					remaining[kept++] = {a, b, remaining[i].index};
+			}
+			
+			offset[slice + 1] = kept - begin;
+		});
+		
+		for(int t = 0 ; t < workers ; ++t)
+			offset[t + 1] += offset[t];
+		
+		compacted.resize(offset[workers]);
+		
+		parallelSlices(remaining.size(), workers, [&](int slice, size_t begin, size_t)
+		{
+			copy(remaining.begin() + begin, remaining.begin() + begin + (offset[slice + 1] - offset[slice]), compacted.begin() + offset[slice]);
+		});
+		
+		remaining.swap(compacted);
+	}
+	
+	return minimumSpanningTree;
+}
+
+//Compressed sparse row graph - the edges of vertex v are edgeIndex[offsets[v]] to edgeIndex[offsets[v + 1] - 1]
+struct CSRGraph
+{
+	vector<int> offsets;
+	vector<int> targets;
+	vector<double> distances;
+	vector<int> edgeIndex;		//position of the edge in the original edge list
+};
+
+//Function to build the CSR graph from an undirected edge list
+CSRGraph buildCSRGraph(const vector<Edge> &edges, int numOfVertices)
+{
+	CSRGraph graph;
+	graph.offsets.assign(numOfVertices + 1, 0);
+	
+	for(const Edge& edge : edges)
+	{
+		graph.offsets[edge.u + 1]++;
+		graph.offsets[edge.v + 1]++;
+	}
+	
+	for(int i = 0 ; i < numOfVertices ; ++i)
+		graph.offsets[i + 1] += graph.offsets[i];
+	
+	graph.targets.resize(graph.offsets[numOfVertices]);
+	graph.distances.resize(graph.offsets[numOfVertices]);
+	graph.edgeIndex.resize(graph.offsets[numOfVertices]);
+	vector<int> next(graph.offsets.begin(), graph.offsets.end() - 1);
+	
+	for(size_t i = 0 ; i < edges.size() ; ++i)
+	{
+		graph.targets[next[edges[i].u]] = edges[i].v;
+		graph.distances[next[edges[i].u]] = edges[i].distance;
+		graph.edgeIndex[next[edges[i].u]++] = i;
+		graph.targets[next[edges[i].v]] = edges[i].u;
+		graph.distances[next[edges[i].v]] = edges[i].distance;
+		graph.edgeIndex[next[edges[i].v]++] = i;
+	}
+	
+	return graph;
+}
+
+//Relabelling of the stations for memory locality, newId[old] is a station's position in the new order and oldId[new] maps it back
+struct VertexOrder
+{
+	vector<int> newId;
+	vector<int> oldId;
+};
+
+//Function to build the order from the list of old ids in their new sequence
+VertexOrder makeVertexOrder(const vector<int>& sequence)
+{
+	VertexOrder order;
+	order.oldId = sequence;
+	order.newId.resize(sequence.size());
+	
+	for(size_t i = 0 ; i < sequence.size() ; ++i)
+		order.newId[sequence[i]] = i;
+	
+	return order;
+}
+
+//Function to compute the position of a point on a 3D Hilbert curve with 'bits' bits per axis (Skilling's transpose method)
+uint64_t hilbertIndex(uint32_t x, uint32_t y, uint32_t z, int bits)
+{
+	uint32_t axes[3] = {x, y, z};
+	
+	//undo the excess rotations and reflections, highest bit first
+	for(uint32_t q = 1u << (bits - 1) ; q > 1 ; q >>= 1)
+	{
+		uint32_t p = q - 1;
+		
+		for(int i = 0 ; i < 3 ; ++i)
+		{
+			if(axes[i] & q)
+			{
+				axes[0] ^= p;
+			}
+			else
+			{
+				uint32_t t = (axes[0] ^ axes[i]) & p;
+				axes[0] ^= t;
+				axes[i] ^= t;
+			}
+		}
+	}
+	
+	//Gray encode
+	axes[1] ^= axes[0];
+	axes[2] ^= axes[1];
+	uint32_t t = 0;
+	
+	for(uint32_t q = 1u << (bits - 1) ; q > 1 ; q >>= 1)
+		if(axes[2] & q)
+			t ^= q - 1;
+	
+	for(int i = 0 ; i < 3 ; ++i)
+		axes[i] ^= t;
+	
+	//interleave the transposed bits into one key
+	uint64_t index = 0;
+	
+	for(int bit = bits - 1 ; bit >= 0 ; --bit)
+		for(int i = 0 ; i < 3 ; ++i)
+			index = (index << 1) | ((axes[i] >> bit) & 1);
+	
+	return index;
+}
+
+//Function to order the stations along a Hilbert curve over x, y and z, so stations close in space get close ids
+VertexOrder hilbertOrder(const vector<Station>& stations)
+{
+	const int bits = 16;
+	int low[3] = {numeric_limits<int> :: max(), numeric_limits<int> :: max(), numeric_limits<int> :: max()};
+	int high[3] = {numeric_limits<int> :: min(), numeric_limits<int> :: min(), numeric_limits<int> :: min()};
+	
+	for(const Station& station : stations)
+	{
+		int position[3] = {station.x, station.y, station.z};
+		
+		for(int axis = 0 ; axis < 3 ; ++axis)
+		{
+			low[axis] = min(low[axis], position[axis]);
+			high[axis] = max(high[axis], position[axis]);
+		}
+	}
+	
+	//scale every axis onto the 2^bits grid of the curve
+	vector<pair<uint64_t, int>> keys(stations.size());
+	
+	for(size_t i = 0 ; i < stations.size() ; ++i)
+	{
+		int position[3] = {stations[i].x, stations[i].y, stations[i].z};
+		uint32_t cell[3];
+		
+		for(int axis = 0 ; axis < 3 ; ++axis)
+		{
+			double span = max(1.0, double(high[axis]) - low[axis]);
+			cell[axis] = uint32_t((double(position[axis]) - low[axis]) / span * ((1u << bits) - 1));
+		}
+		
+		keys[i] = {hilbertIndex(cell[0], cell[1], cell[2], bits), int(i)};
+	}
+	
+	sort(keys.begin(), keys.end());
+	vector<int> sequence(stations.size());
+	
+	for(size_t i = 0 ; i < keys.size() ; ++i)
+		sequence[i] = keys[i].second;
+	
+	return makeVertexOrder(sequence);
+}
+
+//Function to order the vertices by reverse Cuthill-McKee - a BFS from a low degree vertex visiting neighbours by increasing degree, reversed
+VertexOrder cuthillMcKeeOrder(const CSRGraph& graph)
+{
+	int n = graph.offsets.size() - 1;
+	vector<int> byDegree(n);
+	vector<bool> visited(n, false);
+	vector<int> sequence;
+	sequence.reserve(n);
+	
+	for(int i = 0 ; i < n ; ++i)
+		byDegree[i] = i;
+	
+	auto lowerDegree = [&](int a, int b) { return graph.offsets[a + 1] - graph.offsets[a] < graph.offsets[b + 1] - graph.offsets[b]; };
+	stable_sort(byDegree.begin(), byDegree.end(), lowerDegree);
+	
+	//one BFS per component, the queue is the tail of 'sequence'
+	for(int start : byDegree)
+	{
+		if(visited[start])
+			continue;
+		
+		visited[start] = true;
+		sequence.push_back(start);
+		
+		for(size_t head = sequence.size() - 1 ; head < sequence.size() ; ++head)
+		{
+			size_t first = sequence.size();
+			int u = sequence[head];
+			
+			for(int i = graph.offsets[u] ; i < graph.offsets[u + 1] ; ++i)
+			{
+				if(!visited[graph.targets[i]])
+				{
+					visited[graph.targets[i]] = true;
+					sequence.push_back(graph.targets[i]);
+				}
+			}
+			
+			stable_sort(sequence.begin() + first, sequence.end(), lowerDegree);
+		}
+	}
+	
+	reverse(sequence.begin(), sequence.end());
+	return makeVertexOrder(sequence);
+}
+
+//Function to relabel the stations, station i of the result is station order.oldId[i] of the input
+vector<Station> reorderStations(const vector<Station>& stations, const VertexOrder& order)
+{
+	vector<Station> reordered;
+	reordered.reserve(stations.size());
+	
+	for(int old : order.oldId)
+		reordered.push_back(stations[old]);
+	
+	return reordered;
+}
+
+//Function to relabel the end points of every edge, sorted by new end points so equal distances keep a local order
+vector<Edge> reorderEdges(const vector<Edge>& edges, const VertexOrder& order)
+{
+	vector<Edge> reordered;
+	reordered.reserve(edges.size());
+	
+	for(const Edge& edge : edges)
+		reordered.push_back(Edge(min(order.newId[edge.u], order.newId[edge.v]), max(order.newId[edge.u], order.newId[edge.v]), edge.distance));
+	
+	sort(reordered.begin(), reordered.end(), [](const Edge& a, const Edge& b) { return a.u != b.u ? a.u < b.u : a.v < b.v; });
+	return reordered;
+}
+
+//Function to map edges found on a relabelled graph back to the original station ids
+void restoreEdges(const VertexOrder& order, vector<Edge>& edges)
+{
+	for(Edge& edge : edges)
+	{
+		edge.u = order.oldId[edge.u];
+		edge.v = order.oldId[edge.v];
+	}
+}
+
+//Function to map component labels found on a relabelled graph back, label[v] becomes an original id for the original v
+vector<int> restoreComponentLabels(const VertexOrder& order, const vector<int>& label)
+{
+	vector<int> restored(label.size());
+	
+	for(size_t i = 0 ; i < label.size() ; ++i)
+		restored[order.oldId[i]] = order.oldId[label[i]];
+	
+	return restored;
+}
+
+//Binary min heap over vertex ids with decrease-key, position[v] is -1 when v is not in the heap
+struct IndexedHeap
+{
+	vector<int> heap;
+	vector<int> position;
+	vector<double> key;
+	
+	explicit IndexedHeap(int numOfVertices) : position(numOfVertices, -1), key(numOfVertices)
+	{
+	}
+	
+	bool empty() const
+	{
+		return heap.empty();
+	}
+	
+	void swapNodes(int i, int j)
+	{
+		swap(heap[i], heap[j]);
+		position[heap[i]] = i;
+		position[heap[j]] = j;
+	}
+	
+	void siftUp(int i)
+	{
+		while(i > 0 && key[heap[i]] < key[heap[(i - 1) / 2]])
+		{
+			swapNodes(i, (i - 1) / 2);
+			i = (i - 1) / 2;
+		}
+	}
+	
+	void siftDown(int i)
+	{
+		int size = heap.size();
+		
+		while(true)
+		{
+			int smallest = i;
+			int left = 2 * i + 1;
+			int right = 2 * i + 2;
+			
+			if(left < size && key[heap[left]] < key[heap[smallest]])
+				smallest = left;
+			
+			if(right < size && key[heap[right]] < key[heap[smallest]])
+				smallest = right;
+			
+			if(smallest == i)
+				return ;
+			
+			swapNodes(i, smallest);
+			i = smallest;
+		}
+	}
+	
+	//inserts v or lowers its key, keys are never raised
+	void pushOrDecrease(int v, double newKey)
+	{
+		if(position[v] == -1)
+		{
+			key[v] = newKey;
+			position[v] = heap.size();
+			heap.push_back(v);
+		}
+		else
+		{
+			key[v] = newKey;
+		}
+		
+		siftUp(position[v]);
+	}
+	
+	int pop()
+	{
+		int top = heap[0];
+		swapNodes(0, heap.size() - 1);
+		heap.pop_back();
+		position[top] = -1;
+		
+		if(!heap.empty())
+			siftDown(0);
+		
+		return top;
+	}
+};
+
+//Prim's Algorithm - grows the tree from each unvisited vertex, so disconnected graphs give a spanning forest like Kruskal
+vector<Edge> PrimsAlgorithm(const CSRGraph &graph, const vector<Edge> &edges, int numOfVertices)
+{
+	vector<Edge> minimumSpanningTree;
+	IndexedHeap heap(numOfVertices);
+	vector<bool> inTree(numOfVertices, false);
+	vector<int> bestEdge(numOfVertices, -1);	//lightest known edge joining the vertex to the tree
+	
+	for(int root = 0 ; root < numOfVertices ; ++root)
+	{
+		if(inTree[root])
+			continue ;
+		
+		heap.pushOrDecrease(root, 0);
+		
+		while(!heap.empty())
+		{
+			int current = heap.pop();
+			inTree[current] = true;
+			
+			if(bestEdge[current] != -1)
+				minimumSpanningTree.push_back(edges[bestEdge[current]]);
+			
+			for(int i = graph.offsets[current] ; i < graph.offsets[current + 1] ; ++i)
+			{
+				int next = graph.targets[i];
+				
+				if(!inTree[next] && (bestEdge[next] == -1 || graph.distances[i] < heap.key[next]))
+				{
+					bestEdge[next] = graph.edgeIndex[i];
+					heap.pushOrDecrease(next, graph.distances[i]);
+				}
+			}
+		}
+	}
+	
+	return minimumSpanningTree;
+}
+
+vector<Edge> PrimsAlgorithm(const vector<Edge> &edges, int numOfVertices)
+{
+	return PrimsAlgorithm(buildCSRGraph(edges, numOfVertices), edges, numOfVertices);
+}
+
+enum MSTAlgorithm { KRUSKAL, PRIM };
+
+//Function to pick the MST algorithm expected to be fastest
+//Calibrated by timing all three on random graphs of 1k to 200k vertices with average degree 2 to n:
+// - Filter-Kruskal was fastest on one thread whenever the CSR graph had to be built first
+// - Prim on an already built CSR graph only caught up once the average degree reached about 1000
+// - Boruvka is never picked - on one thread it took 2.1s against Filter-Kruskal's 0.53s for 1M vertices and 4M edges,
+//   and 3.1s against 0.32s for 200k vertices and 8M edges, so it would need more than 4x scaling with no multi-core data to show it
+MSTAlgorithm chooseMSTAlgorithm(long long numOfVertices, long long numOfEdges, bool haveCSR)
+{
+	double averageDegree = numOfVertices > 0 ? 2.0 * numOfEdges / numOfVertices : 0;
+	
+	if(haveCSR && averageDegree >= 1000)
+		return PRIM;
+	
+	return KRUSKAL;
+}
+
+//Function to compute the MST with whichever algorithm chooseMSTAlgorithm picks, csr may be null
+vector<Edge> MinimumSpanningTree(const vector<Edge> &edges, int numOfVertices, int numThreads = 0, const CSRGraph* csr = nullptr)
+{
+	if(numThreads <= 0)
+		numThreads = max(1u, thread::hardware_concurrency());
+	
+	switch(chooseMSTAlgorithm(numOfVertices, edges.size(), csr != nullptr))
+	{
+		case PRIM:
+			return PrimsAlgorithm(*csr, edges, numOfVertices);
+		default:
+			return FilterKruskalAlgorithm(edges, numOfVertices, numThreads);
+	}
+}
+
+//Node of the k-d tree over station coordinates, points[begin, end) lie inside the box [low, high]
+struct KdNode
+{
+	int begin, end;
+	int left, right;		//children, -1 for a leaf
+	int low[3], high[3];
+	int component;			//component shared by every point below this node, -1 if mixed
+};
+
+//k-d tree over station coordinates, nodes are stored in preorder so children always follow their parent
+struct KdTree
+{
+	vector<int> points;
+	vector<KdNode> nodes;
+};
+
+int coordinate(const Station& station, int axis)
+{
+	return axis == 0 ? station.x : (axis == 1 ? station.y : station.z);
+}
+
+long long squaredDistance(const Station& a, const Station& b)
+{
+	long long dx = a.x - b.x, dy = a.y - b.y, dz = a.z - b.z;
+	return dx * dx + dy * dy + dz * dz;
+}
+
+//Function to build the k-d tree, splitting each box at the median of its widest axis
+int buildKdNode(KdTree& tree, const vector<Station>& stations, int begin, int end)
+{
+	const int leafSize = 8;
+	int index = tree.nodes.size();
+	tree.nodes.push_back(KdNode());
+	KdNode node = {begin, end, -1, -1, {0, 0, 0}, {0, 0, 0}, -1};
+	
+	for(int axis = 0 ; axis < 3 ; ++axis)
+	{
+		node.low[axis] = node.high[axis] = coordinate(stations[tree.points[begin]], axis);
+		
+		for(int i = begin ; i < end ; ++i)
 		{
-            uniqueRoutes.insert(minmax(a, b));
-            connections[a].insert(b);
-            connections[b].insert(a);
-        }
-    }
-
-    // Transfer unique routes to the vector
-    for (const auto& route : uniqueRoutes) 
+			node.low[axis] = min(node.low[axis], coordinate(stations[tree.points[i]], axis));
+			node.high[axis] = max(node.high[axis], coordinate(stations[tree.points[i]], axis));
+		}
+	}
+	
+	if(end - begin > leafSize)
 	{
-        routes.emplace_back(route);
-    }
-
-    return routes;
+		int axis = 0;
+		
+		for(int a = 1 ; a < 3 ; ++a)
+		{
+			if(node.high[a] - node.low[a] > node.high[axis] - node.low[axis])
+				axis = a;
+		}
+		
+		int middle = begin + (end - begin) / 2;
+		nth_element(tree.points.begin() + begin, tree.points.begin() + middle, tree.points.begin() + end, 
+			[&stations, axis](int a, int b) { return coordinate(stations[a], axis) < coordinate(stations[b], axis); });
+		
+		node.left = buildKdNode(tree, stations, begin, middle);
+		node.right = buildKdNode(tree, stations, middle, end);
+	}
+	
+	tree.nodes[index] = node;
+	return index;
 }
 
-//Structure for edge between two stations
-struct Edge			
+//Candidate edge for the Euclidean MST, ordered by squared distance and then by endpoints so ties are consistent
+struct GeometricEdge
 {
-	int u, v;
-	double distance;
+	long long squared;
+	int u, v;		//u < v
 	
-	Edge(int x, int y, double dist) 
+	bool operator<(const GeometricEdge& other) const
 	{
-		u = x ;
-		v = y ;
-		distance = dist ;
+		if(squared != other.squared)
+			return squared < other.squared;
+		
+		return u != other.u ? u < other.u : v < other.v;
 	}
 };
 
-bool comp(const Edge &a, const Edge &b)
+long long boxSquaredDistance(const KdNode& node, const Station& station)
 {
-	return a.distance < b.distance ;
+	long long total = 0;
+	
+	for(int axis = 0 ; axis < 3 ; ++axis)
+	{
+		long long value = coordinate(station, axis);
+		long long gap = value < node.low[axis] ? node.low[axis] - value : (value > node.high[axis] ? value - node.high[axis] : 0);
+		total += gap * gap;
+	}
+	
+	return total;
 }
 
-//find function - to determine root of set 
-int find(int u, std::vector<int> &parent)
+//Function to find the closest station to 'point' outside its own component, improving 'best' if found
+void nearestOtherComponent(const KdTree& tree, const vector<Station>& stations, const vector<int>& label, int nodeIndex, int point, GeometricEdge& best)
 {
-	if(u == parent[u])		//check if u is its own parent
-		return u;
+	const KdNode& node = tree.nodes[nodeIndex];
+	
+	//whole box is in the same component or too far away
+	if(node.component == label[point] || boxSquaredDistance(node, stations[point]) > best.squared)
+		return ;
+	
+	if(node.left == -1)
+	{
+		for(int i = node.begin ; i < node.end ; ++i)
+		{
+			int other = tree.points[i];
+			
+			if(label[other] == label[point])
+				continue ;
+			
+			GeometricEdge candidate = {squaredDistance(stations[point], stations[other]), min(point, other), max(point, other)};
+			
+			if(candidate < best)
+				best = candidate;
+		}
+		
+		return ;
+	}
+	
+	//visits the closer child first so the bound shrinks sooner
+	int first = node.left, second = node.right;
+	
+	if(boxSquaredDistance(tree.nodes[second], stations[point]) < boxSquaredDistance(tree.nodes[first], stations[point]))
+		swap(first, second);
+	
+	nearestOtherComponent(tree, stations, label, first, point, best);
+	nearestOtherComponent(tree, stations, label, second, point, best);
+}
+
+//Euclidean MST - Boruvka over the complete graph of stations, each component's lightest outgoing edge comes from k-d tree searches
+vector<Edge> EuclideanMST(const vector<Station>& stations)
+{
+	int numOfVertices = stations.size();
+	vector<Edge> minimumSpanningTree;
+	
+	if(numOfVertices < 2)
+		return minimumSpanningTree;
+	
+	KdTree tree;
+	tree.points.resize(numOfVertices);
+	
+	for(int i = 0 ; i < numOfVertices ; ++i)
+		tree.points[i] = i;
+	
+	buildKdNode(tree, stations, 0, numOfVertices);
+	
+	DisjointSet components(numOfVertices);
+	vector<int> label(numOfVertices);
+	const GeometricEdge none = {numeric_limits<long long> :: max(), -1, -1};
+	vector<GeometricEdge> cheapest(numOfVertices, none);
+	
+	while(components.numOfSets > 1)
+	{
+		for(int i = 0 ; i < numOfVertices ; ++i)
+			label[i] = components.find(i);
+		
+		//children follow their parent, so walking backwards labels every child before its parent
+		for(int i = tree.nodes.size() - 1 ; i >= 0 ; --i)
+		{
+			KdNode& node = tree.nodes[i];
+			
+			if(node.left == -1)
+			{
+				node.component = label[tree.points[node.begin]];
+				
+				for(int j = node.begin ; j < node.end && node.component != -1 ; ++j)
+				{
+					if(label[tree.points[j]] != node.component)
+						node.component = -1;
+				}
+			}
+			else
+			{
+				int left = tree.nodes[node.left].component;
+				node.component = left == tree.nodes[node.right].component ? left : -1;
+			}
+		}
+		
+		fill(cheapest.begin(), cheapest.end(), none);
+		
+		//searches start from the best edge already found for the component, which prunes most of the tree
+		for(int point = 0 ; point < numOfVertices ; ++point)
+			nearestOtherComponent(tree, stations, label, 0, point, cheapest[label[point]]);
+		
+		for(int component = 0 ; component < numOfVertices ; ++component)
+		{
+			const GeometricEdge& edge = cheapest[component];
+			
+			if(edge.u != -1 && components.unite(edge.u, edge.v))
+				minimumSpanningTree.emplace_back(edge.u, edge.v, calculateDistance(stations[edge.u], stations[edge.v]));
+		}
+	}
 	
-	return parent[u] = find(parent[u], parent) ;	 
+	return minimumSpanningTree;
 }
 
-//union function - perform union of two sets
-void unionn(int u, int v, std::vector<int> &parent, vector<int> &rank)
+//Link-cut tree over splay trees, every node carries a value and each splay subtree knows the node with the largest value
+struct LinkCutTree
 {
-	//find root to which u and v belong to
-	u = find (u, parent);
-	v = find (v, parent);
+	vector<int> parent;
+	vector<array<int, 2>> child;
+	vector<char> reversed;
+	vector<double> value;
+	vector<int> maxNode;
+	vector<int> splayPath;		//scratch space for splay, kept to avoid an allocation per call
 	
-	if(rank[u] < rank[v])
+	int addNode(double nodeValue)
 	{
-		parent[u] = v ;
+		parent.push_back(-1);
+		child.push_back({-1, -1});
+		reversed.push_back(false);
+		value.push_back(nodeValue);
+		maxNode.push_back(value.size() - 1);
+		return value.size() - 1;
 	}
-	else if(rank[v] < rank[u])
+	
+	//resets a node that is no longer linked so it can be reused
+	void resetNode(int x, double nodeValue)
 	{
-		parent[v] = u ;
+		parent[x] = -1;
+		child[x] = {-1, -1};
+		reversed[x] = false;
+		value[x] = nodeValue;
+		maxNode[x] = x;
 	}
-	else
+	
+	bool isSplayRoot(int x)
 	{
-		parent[v] = u ;
-		rank[u] ++ ;
-	}	
-}
+		int p = parent[x];
+		return p == -1 || (child[p][0] != x && child[p][1] != x);
+	}
+	
+	void pushUp(int x)
+	{
+		maxNode[x] = x;
+		
+		for(int c : child[x])
+		{
+			if(c != -1 && value[maxNode[c]] > value[maxNode[x]])
+				maxNode[x] = maxNode[c];
+		}
+	}
+	
+	void pushDown(int x)
+	{
+		if(!reversed[x])
+			return ;
+		
+		swap(child[x][0], child[x][1]);
+		
+		for(int c : child[x])
+		{
+			if(c != -1)
+				reversed[c] = !reversed[c];
+		}
+		
+		reversed[x] = false;
+	}
+	
+	void rotate(int x)
+	{
+		int p = parent[x], g = parent[p];
+		int side = child[p][1] == x;
+		
+		if(!isSplayRoot(p))
+			child[g][child[g][1] == p] = x;
+		
+		parent[x] = g;
+		child[p][side] = child[x][!side];
+		
+		if(child[x][!side] != -1)
+			parent[child[x][!side]] = p;
+		
+		child[x][!side] = p;
+		parent[p] = x;
+		pushUp(p);
+		pushUp(x);
+	}
+	
+	void splay(int x)
+	{
+		//pending reversals are pushed from the top of the splay tree down to x first
+		splayPath.assign(1, x);
+		
+		for(int y = x ; !isSplayRoot(y) ; y = parent[y])
+			splayPath.push_back(parent[y]);
+		
+		for(int i = splayPath.size() - 1 ; i >= 0 ; --i)
+			pushDown(splayPath[i]);
+		
+		while(!isSplayRoot(x))
+		{
+			int p = parent[x];
+			
+			if(!isSplayRoot(p))
+				rotate((child[p][1] == x) == (child[parent[p]][1] == p) ? p : x);
+			
+			rotate(x);
+		}
+	}
+	
+	void access(int x)
+	{
+		for(int last = -1, y = x ; y != -1 ; last = y, y = parent[y])
+		{
+			splay(y);
+			child[y][1] = last;
+			pushUp(y);
+		}
+		
+		splay(x);
+	}
+	
+	void makeRoot(int x)
+	{
+		access(x);
+		reversed[x] = !reversed[x];
+	}
+	
+	int findRoot(int x)
+	{
+		access(x);
+		
+		for(pushDown(x) ; child[x][0] != -1 ; pushDown(x))
+			x = child[x][0];
+		
+		splay(x);
+		return x;
+	}
+	
+	bool connected(int x, int y)
+	{
+		return findRoot(x) == findRoot(y);
+	}
+	
+	void link(int x, int y)
+	{
+		makeRoot(x);
+		parent[x] = y;
+	}
+	
+	void cut(int x, int y)
+	{
+		makeRoot(x);
+		access(y);
+		child[y][0] = -1;		//x is now the only node left of y on the path
+		parent[x] = -1;
+		pushUp(y);
+	}
+	
+	//node with the largest value on the tree path between x and y
+	int pathMax(int x, int y)
+	{
+		makeRoot(x);
+		access(y);
+		return maxNode[y];
+	}
+};
 
-vector<Edge> KruskalsAlgorithm (const vector<Edge> &edges, int numOfVertices)
+//Online MST - routes arrive one at a time, a new route replaces the longest route on the cycle it closes
+//Vertices are link-cut nodes 0 to numOfVertices - 1, every forest edge is a node of its own linked between its ends
+struct OnlineMST
 {
-	vector<Edge> minimumSpanningTree;
+	int numOfVertices;
+	LinkCutTree tree;
+	DisjointSet components;			//a replacement keeps both ends connected, so connectivity only ever grows
+	vector<Edge> forestEdges;		//forestEdges[i] is the route held by link-cut node numOfVertices + i
+	vector<bool> inForest;
+	vector<int> freeNodes;
+	double total = 0;
+	int size = 0;
 	
-	//initializes parent array
-	vector<int> parent(numOfVertices);
+	explicit OnlineMST(int vertices) : numOfVertices(vertices), components(vertices)
+	{
+		for(int i = 0 ; i < numOfVertices ; ++i)
+			tree.addNode(-numeric_limits<double> :: infinity());
+	}
 	
-	for(int i = 0 ; i < numOfVertices ; i++)
-		parent[i] = i;
+	//adds a route, returns true if it is now part of the spanning forest
+	bool insertEdge(const Edge& edge)
+	{
+		if(edge.u == edge.v)
+			return false;
+		
+		if(!components.unite(edge.u, edge.v))
+		{
+			int heaviest = tree.pathMax(edge.u, edge.v);
+			
+			if(tree.value[heaviest] <= edge.distance)
+				return false;
+			
+			removeForestEdge(heaviest);
+		}
 		
-	vector<int> rank(numOfVertices, 0);
+		int node;
+		
+		if(freeNodes.empty())
+		{
+			node = tree.addNode(edge.distance);
+			forestEdges.push_back(edge);
+			inForest.push_back(true);
+		}
+		else
+		{
+			node = freeNodes.back();
+			freeNodes.pop_back();
+			tree.resetNode(node, edge.distance);
+			forestEdges[node - numOfVertices] = edge;
+			inForest[node - numOfVertices] = true;
+		}
+		
+		tree.link(edge.u, node);
+		tree.link(node, edge.v);
+		total += edge.distance;
+		size++;
+		
+		return true;
+	}
 	
-	//sort edges in non-decreasing order of distance
-	vector<Edge> sortedEdges = edges ;
-	sort(sortedEdges.begin(), sortedEdges.end(), comp);
+	void removeForestEdge(int node)
+	{
+		const Edge& edge = forestEdges[node - numOfVertices];
+		
+		tree.cut(edge.u, node);
+		tree.cut(node, edge.v);
+		total -= edge.distance;
+		size--;
+		inForest[node - numOfVertices] = false;
+		freeNodes.push_back(node);
+	}
 	
-	for(const Edge &edge : sortedEdges)
-	{		
-		if(find(edge.u, parent) != find(edge.v, parent))
+	double totalDistance() const
+	{
+		return total;
+	}
+	
+	vector<Edge> currentEdges() const
+	{
+		vector<Edge> edges;
+		
+		for(size_t i = 0 ; i < forestEdges.size() ; ++i)
 		{
-			minimumSpanningTree.push_back(edge);
-			unionn(edge.u, edge.v, parent, rank);
+			if(inForest[i])
+				edges.push_back(forestEdges[i]);
 		}
+		
+		return edges;
+	}
+};
+
+//Lock-free disjoint set - roots are linked with compare-and-swap and paths are split concurrently
+//A root is only ever linked below a root of higher priority, so no thread can build a cycle
+struct ConcurrentDisjointSet
+{
+	int numOfElements;
+	unique_ptr<atomic<int>[]> parent;
+	
+	explicit ConcurrentDisjointSet(int elements) : numOfElements(elements), parent(new atomic<int>[elements])
+	{
+		for(int i = 0 ; i < numOfElements ; ++i)
+			parent[i].store(i, memory_order_relaxed);
 	}
 	
-	return minimumSpanningTree ;
-} 
+	//pseudo-random priority from the index, keeps the trees shallow whatever order the unions arrive in
+	static unsigned int priority(int u)
+	{
+		unsigned int x = u;
+		x ^= x >> 16;
+		x *= 0x7feb352d;
+		x ^= x >> 15;
+		x *= 0x846ca68b;
+		x ^= x >> 16;
+		return x;
+	}
+	
+	static bool higher(int u, int v)
+	{
+		unsigned int pu = priority(u), pv = priority(v);
+		return pu != pv ? pu > pv : u > v;
+	}
+	
+	//find function - path splitting, each step tries to point u at its grandparent; a failed CAS only means another thread helped
+	int find(int u)
+	{
+		while(true)
+		{
+			int p = parent[u].load(memory_order_acquire);
+			
+			if(p == u)
+				return u;
+			
+			int grandparent = parent[p].load(memory_order_acquire);
+			
+			if(p != grandparent)
+				parent[u].compare_exchange_weak(p, grandparent, memory_order_release, memory_order_relaxed);
+			
+			u = p;
+		}
+	}
+	
+	//union function - links the lower priority root below the other, retrying if either root changed meanwhile
+	bool unite(int u, int v)
+	{
+		while(true)
+		{
+			u = find(u);
+			v = find(v);
+			
+			if(u == v)
+				return false;
+			
+			if(higher(u, v))
+				swap(u, v);
+			
+			int expected = u;
+			
+			if(parent[u].compare_exchange_strong(expected, v, memory_order_acq_rel))
+				return true;
+		}
+	}
+	
+	bool connected(int u, int v)
+	{
+		while(true)
+		{
+			u = find(u);
+			v = find(v);
+			
+			if(u == v)
+				return true;
+			
+			if(parent[u].load(memory_order_acquire) == u)		//u is still a root, so they really were apart
+				return false;
+		}
+	}
+};
+
+//Function to label connected components with all threads, label[v] is the root of v's component
+vector<int> ParallelConnectedComponents(const vector<Edge> &edges, int numOfVertices, int numThreads = 0)
+{
+	if(numThreads <= 0)
+		numThreads = max(1u, thread::hardware_concurrency());
+	
+	ConcurrentDisjointSet components(numOfVertices);
+	vector<int> label(numOfVertices);
+	
+	parallelFor(edges.size(), numThreads, [&](size_t begin, size_t end)
+	{
+		for(size_t i = begin ; i < end ; ++i)
+			components.unite(edges[i].u, edges[i].v);
+	});
+	
+	parallelFor(numOfVertices, numThreads, [&](size_t begin, size_t end)
+	{
+		for(size_t i = begin ; i < end ; ++i)
+			label[i] = components.find(i);
+	});
+	
+	return label;
+}
+
+//Function to add up the distances of a set of edges, used to cross-check the MST variants
+double totalDistance(const vector<Edge>& edges)
+{
+	double total = 0;
+	
+	for(const Edge& edge : edges)
+		total += edge.distance;
+	
+	return total;
+}
 
 //Function to generate Graphviz for Minimum Spaning Tree
 void graphMST(const vector<Station>& stations, const vector<Edge>& minimumSpanningTree)
@@ -281,6 +1572,115 @@ int main()
     // Inform the user
     cout << "Graphviz DOT file generated: MSTGraph.dot" << endl;
     
+    //Filter-Kruskal, Boruvka and Prim must find a tree of the same total distance
+    vector<Edge> filterTree = FilterKruskalAlgorithm(edges, stations.size());
+    vector<Edge> boruvkaTree = BoruvkaAlgorithm(edges, stations.size());
+    vector<Edge> primTree = PrimsAlgorithm(edges, stations.size());
+    
+    if(filterTree.size() != minimumSpanningTree.size() || abs(totalDistance(filterTree) - totalDistance(minimumSpanningTree)) > 1e-6)
+    {
+    	cerr << "Error: Filter-Kruskal tree differs from Kruskal" << endl;
+    	return 1;
+	}
+    
+    if(boruvkaTree.size() != minimumSpanningTree.size() || abs(totalDistance(boruvkaTree) - totalDistance(minimumSpanningTree)) > 1e-6)
+    {
+    	cerr << "Error: Boruvka tree differs from Kruskal" << endl;
+    	return 1;
+	}
+    
+    if(primTree.size() != minimumSpanningTree.size() || abs(totalDistance(primTree) - totalDistance(minimumSpanningTree)) > 1e-6)
+    {
+    	cerr << "Error: Prim tree differs from Kruskal" << endl;
+    	return 1;
+	}
+    
+    //the dispatcher, with and without a prebuilt CSR graph
+    CSRGraph csr = buildCSRGraph(edges, stations.size());
+    
+    for(const vector<Edge>& tree : {MinimumSpanningTree(edges, stations.size()), MinimumSpanningTree(edges, stations.size(), 0, &csr)})
+    {
+    	if(tree.size() != minimumSpanningTree.size() || abs(totalDistance(tree) - totalDistance(minimumSpanningTree)) > 1e-6)
+    	{
+    		cerr << "Error: MinimumSpanningTree differs from Kruskal" << endl;
+    		return 1;
+		}
+	}
+    
+    cout << "Minimum Spanning Tree total distance : " << totalDistance(minimumSpanningTree) << " (Filter-Kruskal, Boruvka, Prim and the dispatcher match)" << endl;
+    
+    //Euclidean MST over every pair of stations, checked against Kruskal on the complete graph
+    vector<Edge> completeEdges;
+    int n = stations.size();
+    
+    for(int i = 0 ; i < n ; ++i)
+    {
+    	for(int j = i + 1 ; j < n ; ++j)
+    		completeEdges.emplace_back(i, j, calculateDistance(stations[i], stations[j]));
+	}
+    
+    vector<Edge> euclideanTree = EuclideanMST(stations);
+    
+    if(abs(totalDistance(euclideanTree) - totalDistance(KruskalsAlgorithm(completeEdges, stations.size()))) > 1e-6)
+    {
+    	cerr << "Error: Euclidean MST differs from Kruskal on the complete graph" << endl;
+    	return 1;
+	}
+    
+    cout << "Euclidean Minimum Spanning Tree total distance : " << totalDistance(euclideanTree) << endl;
+    
+    //Online MST - the routes arrive one at a time instead of as a full edge list
+    OnlineMST onlineTree(stations.size());
+    
+    for(const Edge& edge : edges)
+    	onlineTree.insertEdge(edge);
+    
+    if(abs(onlineTree.totalDistance() - totalDistance(minimumSpanningTree)) > 1e-6 || onlineTree.currentEdges().size() != minimumSpanningTree.size())
+    {
+    	cerr << "Error: online MST differs from Kruskal" << endl;
+    	return 1;
+	}
+    
+    cout << "Online Minimum Spanning Tree matches Kruskal after " << edges.size() << " route insertions" << endl;
+    
+    //Connected components with the lock-free disjoint set, a spanning tree has one edge less than the stations it connects
+    vector<int> componentLabel = ParallelConnectedComponents(edges, stations.size());
+    set<int> componentRoots(componentLabel.begin(), componentLabel.end());
+    
+    if(componentRoots.size() + minimumSpanningTree.size() != stations.size())
+    {
+    	cerr << "Error: parallel connected components disagree with the spanning tree" << endl;
+    	return 1;
+	}
+    
+    cout << "Connected components : " << componentRoots.size() << endl;
+
+    //Kruskal on the stations relabelled along a Hilbert curve, components on the Cuthill-McKee order, both mapped back to the original ids
+    VertexOrder spatialOrder = hilbertOrder(stations);
+    vector<Edge> reorderedTree = KruskalsAlgorithm(reorderEdges(edges, spatialOrder), stations.size());
+    restoreEdges(spatialOrder, reorderedTree);
+
+    VertexOrder bandOrder = cuthillMcKeeOrder(buildCSRGraph(edges, stations.size()));
+    vector<int> reorderedLabel = restoreComponentLabels(bandOrder, ParallelConnectedComponents(reorderEdges(edges, bandOrder), stations.size()));
+    map<int, int> sameComponent;
+
+    for(size_t i = 0 ; i < stations.size() ; ++i)
+    {
+    	if(sameComponent.emplace(reorderedLabel[i], componentLabel[i]).first->second != componentLabel[i])
+    	{
+    		cerr << "Error: connected components on the relabelled graph differ" << endl;
+    		return 1;
+		}
+	}
+
+    if(abs(totalDistance(reorderedTree) - totalDistance(minimumSpanningTree)) > 1e-6 || sameComponent.size() != componentRoots.size())
+    {
+    	cerr << "Error: results on the relabelled graph differ from the original labelling" << endl;
+    	return 1;
+	}
+
+    cout << "Kruskal and connected components on the relabelled stations match the original labelling" << endl;
+
     return 0;
 }
 
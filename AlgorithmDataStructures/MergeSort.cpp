@@ -3,6 +3,7 @@
 #include <chrono>
 #include <random> 
 #include "matplotlibcpp.h"
+#include "Instrumentation.h"
 
 namespace plt = matplotlibcpp;
 
@@ -58,6 +59,7 @@ void merge(std::vector<int>& arr, int left, int middle, int right) {
         }
         k++;
     }
+    INSTRUMENT_COUNT("merge.comparisons", i + j);
 
     // Copy the remaining elements of leftArray[], if there are any
     while (i < n1) {
@@ -91,6 +93,7 @@ void mergeSort(std::vector<int>& arr, int left, int right) {
 
 // Function to perform Merge Sort and measure time
 void runMergeSort(std::vector<int>& arr, std::vector<long long>& timings) {
+    INSTRUMENT_PHASE("mergeSort");
     auto start_time = std::chrono::high_resolution_clock::now();
 
     int n = arr.size();
@@ -1,6 +1,15 @@
 #include <iostream>
 #include <vector>
 #include<algorithm> //include the header for reverse
+#include <cstdint>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <memory>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include "Instrumentation.h"
 
 using namespace std;
 
@@ -30,6 +39,7 @@ vector<Station> loadDataset() {
 }
 
 vector<Station> solveKnapsack(const vector<Station>& stations, int maxCapacity) {
+    INSTRUMENT_PHASE("solveKnapsack");
     int numStations = stations.size();
     // Create a 2D table to store the maximum profit for each station and capacity combination.
     vector<vector<int>> dp(numStations + 1, vector<int>(maxCapacity + 1, 0));
@@ -44,6 +54,7 @@ vector<Station> solveKnapsack(const vector<Station>& stations, int maxCapacity)
             }
         }
     }
+    INSTRUMENT_COUNT("knapsack.cells", (long long)numStations * maxCapacity);
 
     // Trace back to find the selected stations.
     int i = numStations;
@@ -62,6 +73,457 @@ vector<Station> solveKnapsack(const vector<Station>& stations, int maxCapacity)
     return selectedStations;
 }
 
+// Value-only knapsack: a single DP row updated from high to low capacity, so each item is used at most once.
+int knapsackMaxProfit(const vector<Station>& stations, int maxCapacity) {
+    vector<int> dp(maxCapacity + 1, 0);
+
+    for (const Station& station : stations) {
+        for (int w = maxCapacity; w >= max(station.weight, 1); --w) {
+            dp[w] = max(dp[w], dp[w - station.weight] + station.profit);
+        }
+    }
+
+    return dp[maxCapacity];
+}
+
+// Final DP row plus a 1 bit per cell "station taken" matrix, enough to trace back the stations for any capacity up to maxCapacity.
+struct KnapsackTable {
+    int maxCapacity;
+    size_t wordsPerRow;
+    vector<int> profit;
+    vector<uint64_t> taken;
+};
+
+// Trace back to find the selected stations for one capacity.
+vector<Station> traceKnapsack(const vector<Station>& stations, const KnapsackTable& table, int capacity) {
+    int w = capacity;
+    vector<Station> selectedStations;
+
+    for (int i = stations.size() - 1; i >= 0 && w > 0; --i) {
+        if (table.taken[i * table.wordsPerRow + w / 64] >> (w % 64) & 1) {
+            selectedStations.push_back(stations[i]);
+            w -= stations[i].weight;
+        }
+    }
+
+    reverse(selectedStations.begin(), selectedStations.end());
+    return selectedStations;
+}
+
+// Builds the table with one DP row, so memory is 1 bit per cell instead of the 4 bytes of solveKnapsack.
+KnapsackTable buildKnapsackTable(const vector<Station>& stations, int maxCapacity) {
+    int numStations = stations.size();
+    KnapsackTable table = {maxCapacity, size_t(maxCapacity + 1 + 63) / 64, vector<int>(maxCapacity + 1, 0), {}};
+    table.taken.assign(numStations * table.wordsPerRow, 0);
+    vector<int>& dp = table.profit;
+
+    for (int i = 0; i < numStations; ++i) {
+        const Station& station = stations[i];
+        uint64_t* row = &table.taken[i * table.wordsPerRow];
+
+        // Going down keeps dp[w - weight] at the previous station's value.
+        for (int w = maxCapacity; w >= max(station.weight, 1); --w) {
+            int withStation = dp[w - station.weight] + station.profit;
+            if (withStation > dp[w]) {
+                dp[w] = withStation;
+                row[w / 64] |= uint64_t(1) << (w % 64);
+            }
+        }
+    }
+
+    return table;
+}
+
+// Same answer as solveKnapsack using the compact table.
+vector<Station> solveKnapsackCompact(const vector<Station>& stations, int maxCapacity) {
+    return traceKnapsack(stations, buildKnapsackTable(stations, maxCapacity), maxCapacity);
+}
+
+// Fills cur[w] = max(prev[w], prev[w - weight] + profit) for the 64-cell words [firstWord, lastWord),
+// setting the "taken" bit of every cell where the station improves the profit.
+void knapsackRowKernel(const int* prev, int* cur, uint64_t* takenRow, int maxCapacity,
+                       size_t firstWord, size_t lastWord, int weight, int profit) {
+    int lowest = max(weight, 1);  // cells below this cannot take the station, and w = 0 is never filled
+
+    for (size_t word = firstWord; word < lastWord; ++word) {
+        int begin = word * 64;
+        int end = min<long long>(begin + 64, maxCapacity + 1);
+        uint64_t bits = 0;
+
+#ifdef __AVX2__
+        if (begin >= lowest && end - begin == 64) {
+            __m256i profits = _mm256_set1_epi32(profit);
+            for (int lane = 0; lane < 64; lane += 8) {
+                __m256i skip = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + begin + lane));
+                __m256i take = _mm256_add_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(prev + begin + lane - weight)), profits);
+                __m256i better = _mm256_cmpgt_epi32(take, skip);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(cur + begin + lane), _mm256_max_epi32(take, skip));
+                bits |= uint64_t(_mm256_movemask_ps(_mm256_castsi256_ps(better))) << lane;
+            }
+            takenRow[word] = bits;
+            continue;
+        }
+#endif
+
+        // Branchless scalar path: the comparison result selects the value and becomes the bit.
+        for (int w = begin; w < end; ++w) {
+            int skip = prev[w];
+            int take = w >= lowest ? prev[w - weight] + profit : skip;
+            uint64_t better = take > skip;
+            cur[w] = better ? take : skip;
+            bits |= better << (w - begin);
+        }
+        takenRow[word] = bits;
+    }
+}
+
+// Barrier for the row-parallel solver: every thread finishes a station before any thread starts the next one.
+struct RowBarrier {
+    mutex lock;
+    condition_variable released;
+    int numThreads;
+    int waiting = 0;
+    long long generation = 0;
+
+    explicit RowBarrier(int threads) : numThreads(threads) {}
+
+    void wait() {
+        unique_lock<mutex> guard(lock);
+        long long current = generation;
+        if (++waiting == numThreads) {
+            waiting = 0;
+            ++generation;
+            released.notify_all();
+        } else {
+            released.wait(guard, [&] { return generation != current; });
+        }
+    }
+};
+
+// Builds the same table as buildKnapsackTable, with each DP row filled by the vector kernel and split into capacity blocks across threads.
+// Build with -mavx2 (or -march=native) to enable the 8-lane kernel; otherwise the branchless scalar loop is used.
+KnapsackTable buildKnapsackTableParallel(const vector<Station>& stations, int maxCapacity, int numThreads = 0) {
+    int numStations = stations.size();
+    size_t wordsPerRow = (maxCapacity + 1 + 63) / 64;
+    vector<int> rows[2] = {vector<int>(maxCapacity + 1, 0), vector<int>(maxCapacity + 1, 0)};
+    vector<uint64_t> taken(numStations * wordsPerRow, 0);
+
+    if (numThreads <= 0) {
+        numThreads = max(1u, thread::hardware_concurrency());
+    }
+    // Blocks smaller than a few thousand cells cost more to synchronise than to fill.
+    numThreads = max<size_t>(1, min<size_t>(numThreads, wordsPerRow / 64));
+
+    RowBarrier barrier(numThreads);
+    auto worker = [&](int t) {
+        size_t firstWord = wordsPerRow * t / numThreads;
+        size_t lastWord = wordsPerRow * (t + 1) / numThreads;
+        for (int i = 0; i < numStations; ++i) {
+            const vector<int>& prev = rows[i % 2];
+            vector<int>& cur = rows[(i + 1) % 2];
+            knapsackRowKernel(prev.data(), cur.data(), &taken[i * wordsPerRow], maxCapacity,
+                              firstWord, lastWord, stations[i].weight, stations[i].profit);
+            if (numThreads > 1) {
+                barrier.wait();
+            }
+        }
+    };
+
+    vector<thread> threads;
+    for (int t = 1; t < numThreads; ++t) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (thread& t : threads) {
+        t.join();
+    }
+
+    return {maxCapacity, wordsPerRow, move(rows[numStations % 2]), move(taken)};
+}
+
+// Same answer as solveKnapsack using the vectorised, multi-threaded table.
+vector<Station> solveKnapsackParallel(const vector<Station>& stations, int maxCapacity, int numThreads = 0) {
+    return traceKnapsack(stations, buildKnapsackTableParallel(stations, maxCapacity, numThreads), maxCapacity);
+}
+
+// Best profit for every capacity 0..capacity using only stations[first, last).
+vector<int> knapsackRow(const vector<Station>& stations, int first, int last, int capacity) {
+    vector<int> dp(capacity + 1, 0);
+
+    for (int i = first; i < last; ++i) {
+        for (int w = capacity; w >= stations[i].weight; --w) {
+            dp[w] = max(dp[w], dp[w - stations[i].weight] + stations[i].profit);
+        }
+    }
+
+    return dp;
+}
+
+// Picks the stations of [first, last) for an optimal load of at most capacity, appending their indices in order.
+void divideKnapsack(const vector<Station>& stations, int first, int last, int capacity, vector<int>& selected) {
+    if (last - first == 1) {
+        if (stations[first].weight <= capacity && stations[first].profit > 0) {
+            selected.push_back(first);
+        }
+        return;
+    }
+
+    // Split the capacity where the best first half plus the best second half is largest.
+    int middle = first + (last - first) / 2;
+    int split = 0;
+    {
+        vector<int> front = knapsackRow(stations, first, middle, capacity);
+        vector<int> back = knapsackRow(stations, middle, last, capacity);
+        for (int c = 1; c <= capacity; ++c) {
+            if (front[c] + back[capacity - c] > front[split] + back[capacity - split]) {
+                split = c;
+            }
+        }
+    }  // both rows are freed before recursing, so only O(capacity) memory is live at any depth
+
+    divideKnapsack(stations, first, middle, split, selected);
+    divideKnapsack(stations, middle, last, capacity - split, selected);
+}
+
+// Same kind of answer as solveKnapsack in O(maxCapacity) memory: the halves are re-solved at the best capacity split.
+// Time stays within about twice the full table, since the capacities of the two halves always add up to the parent's.
+vector<Station> solveKnapsackDivide(const vector<Station>& stations, int maxCapacity) {
+    vector<int> selected;
+    vector<Station> selectedStations;
+
+    if (!stations.empty() && maxCapacity > 0) {
+        divideKnapsack(stations, 0, stations.size(), maxCapacity, selected);
+    }
+
+    for (int i : selected) {
+        selectedStations.push_back(stations[i]);
+    }
+    return selectedStations;
+}
+
+// One non-dominated load: total weight, total profit and the choice that produced it.
+struct ParetoState {
+    long long weight;
+    long long profit;
+    int choice;  // index into the choice pool, -1 for the empty load
+};
+
+// Chain of taken stations shared between states, so a state only adds one link when it takes a station.
+struct ParetoChoice {
+    int station;
+    int previous;
+};
+
+// Sparse knapsack: keeps only the (weight, profit) pairs no other pair beats, so the time depends on the frontier
+// size instead of maxCapacity. Each station merges the frontier with a copy shifted by that station in one pass.
+vector<Station> solveKnapsackPareto(const vector<Station>& stations, long long maxCapacity) {
+    vector<ParetoState> frontier = {{0, 0, -1}};
+    vector<ParetoState> merged;
+    vector<ParetoChoice> choices;
+
+    for (int i = 0; i < (int)stations.size(); ++i) {
+        const Station& station = stations[i];
+        if (station.profit <= 0 || station.weight > maxCapacity) {
+            continue;
+        }
+
+        merged.clear();
+        size_t a = 0, b = 0;  // a walks the frontier without the station, b walks the frontier with it
+
+        while (a < frontier.size() || b < frontier.size()) {
+            ParetoState next;
+            bool haveShifted = b < frontier.size() && frontier[b].weight + station.weight <= maxCapacity;
+
+            if (!haveShifted && a >= frontier.size()) {
+                break;
+            }
+            if (haveShifted && (a >= frontier.size() || frontier[b].weight + station.weight < frontier[a].weight
+                || (frontier[b].weight + station.weight == frontier[a].weight && frontier[b].profit + station.profit > frontier[a].profit))) {
+                next = {frontier[b].weight + station.weight, frontier[b].profit + station.profit, (int)choices.size()};
+                choices.push_back({i, frontier[b].choice});
+                ++b;
+            } else {
+                next = frontier[a++];
+            }
+
+            // Frontier stays sorted by weight with strictly rising profit, anything else is dominated.
+            if (merged.empty() || next.profit > merged.back().profit) {
+                if (!merged.empty() && merged.back().weight == next.weight) {
+                    merged.back() = next;
+                } else {
+                    merged.push_back(next);
+                }
+            }
+        }
+
+        frontier.swap(merged);
+    }
+
+    vector<Station> selectedStations;
+    for (int c = frontier.back().choice; c != -1; c = choices[c].previous) {
+        selectedStations.push_back(stations[choices[c].station]);
+    }
+
+    reverse(selectedStations.begin(), selectedStations.end());
+    return selectedStations;
+}
+
+// Branch and bound: stations are tried best profit per weight first, and a branch is dropped as soon as the
+// greedy fractional fill of the remaining capacity cannot beat the best load found so far.
+vector<Station> solveKnapsackBranchAndBound(const vector<Station>& stations, long long maxCapacity) {
+    vector<int> order;
+    for (int i = 0; i < (int)stations.size(); ++i) {
+        if (stations[i].profit > 0 && stations[i].weight <= maxCapacity) {
+            order.push_back(i);
+        }
+    }
+    sort(order.begin(), order.end(), [&stations](int a, int b) {
+        return (long long)stations[a].profit * stations[b].weight > (long long)stations[b].profit * stations[a].weight;
+    });
+
+    int n = order.size();
+    vector<bool> current(n, false), best(n, false);
+    long long bestProfit = 0;
+
+    // Upper bound for stations order[k..] with the given room left.
+    auto bound = [&](int k, long long room) {
+        double total = 0;
+        for (; k < n && stations[order[k]].weight <= room; ++k) {
+            room -= stations[order[k]].weight;
+            total += stations[order[k]].profit;
+        }
+        if (k < n && stations[order[k]].weight > 0) {
+            total += (double)stations[order[k]].profit * room / stations[order[k]].weight;
+        }
+        return total;
+    };
+
+    // Depth first search with an explicit stack of (depth, room, profit, take?) so deep station lists are safe.
+    struct Frame { int depth; long long room; long long profit; bool take; };
+    vector<Frame> stack = {{0, maxCapacity, 0, false}, {0, maxCapacity, 0, true}};
+
+    while (!stack.empty()) {
+        Frame frame = stack.back();
+        stack.pop_back();
+
+        if (frame.depth == n) {
+            continue;
+        }
+
+        const Station& station = stations[order[frame.depth]];
+        long long room = frame.room, profit = frame.profit;
+        if (frame.take) {
+            if (station.weight > room) {
+                continue;
+            }
+            room -= station.weight;
+            profit += station.profit;
+        }
+        current[frame.depth] = frame.take;
+
+        if (profit > bestProfit) {
+            bestProfit = profit;
+            best.assign(current.begin(), current.begin() + frame.depth + 1);
+            best.resize(n, false);
+        }
+
+        if (profit + bound(frame.depth + 1, room) > bestProfit + 1e-9) {
+            stack.push_back({frame.depth + 1, room, profit, false});
+            stack.push_back({frame.depth + 1, room, profit, true});  // taking is explored first
+        }
+    }
+
+    vector<int> taken;
+    for (int k = 0; k < n; ++k) {
+        if (best[k]) {
+            taken.push_back(order[k]);
+        }
+    }
+    sort(taken.begin(), taken.end());
+
+    vector<Station> selectedStations;
+    for (int i : taken) {
+        selectedStations.push_back(stations[i]);
+    }
+    return selectedStations;
+}
+
+// Answer to one capacity of a batch query.
+struct KnapsackAnswer {
+    int capacity;
+    int profit;
+    vector<Station> stations;
+};
+
+// Tables built by earlier batches, kept per station set so repeated calls skip the DP entirely.
+struct KnapsackCache {
+    static const size_t maxEntries = 8;
+    mutex lock;
+    vector<pair<vector<Station>, shared_ptr<const KnapsackTable>>> entries;  // most recently used last
+};
+
+bool sameStations(const vector<Station>& a, const vector<Station>& b) {
+    if (a.size() != b.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i].name != b[i].name || a[i].weight != b[i].weight || a[i].profit != b[i].profit) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Answers every capacity from one DP pass up to the largest one: the decision bits of a row are valid for all capacities,
+// so each answer is just a trace-back. The table is cached and reused while the station set and capacities fit.
+vector<KnapsackAnswer> solveKnapsackBatch(const vector<Station>& stations, const vector<int>& capacities) {
+    static KnapsackCache cache;
+    int largest = 0;
+    for (int capacity : capacities) {
+        largest = max(largest, capacity);
+    }
+
+    shared_ptr<const KnapsackTable> table;
+    {
+        lock_guard<mutex> guard(cache.lock);
+        for (size_t i = 0; i < cache.entries.size(); ++i) {
+            if (sameStations(cache.entries[i].first, stations) && cache.entries[i].second->maxCapacity >= largest) {
+                table = cache.entries[i].second;
+                rotate(cache.entries.begin() + i, cache.entries.begin() + i + 1, cache.entries.end());
+                break;
+            }
+        }
+    }
+
+    if (!table) {
+        table = make_shared<const KnapsackTable>(buildKnapsackTableParallel(stations, largest));
+
+        lock_guard<mutex> guard(cache.lock);
+        // A larger table for the same stations replaces the smaller one.
+        for (size_t i = 0; i < cache.entries.size(); ++i) {
+            if (sameStations(cache.entries[i].first, stations)) {
+                cache.entries.erase(cache.entries.begin() + i);
+                break;
+            }
+        }
+        if (cache.entries.size() == KnapsackCache::maxEntries) {
+            cache.entries.erase(cache.entries.begin());
+        }
+        cache.entries.push_back({stations, table});
+    }
+
+    vector<KnapsackAnswer> answers;
+    for (int capacity : capacities) {
+        KnapsackAnswer answer = {capacity, 0, {}};
+        if (capacity > 0) {
+            answer.profit = table->profit[capacity];
+            answer.stations = traceKnapsack(stations, *table, capacity);
+        }
+        answers.push_back(answer);
+    }
+    return answers;
+}
+
 int main() {
     vector<Station> stations = loadDataset();
     int maxCapacity = 800;
@@ -75,5 +537,51 @@ int main() {
         cout << "Weight: " << station.weight << " Profit: " << station.profit << endl;
     }
 
+    // The compact and parallel solvers must pick the same stations.
+    vector<Station> compactStations = solveKnapsackCompact(stations, maxCapacity);
+    vector<Station> parallelStations = solveKnapsackParallel(stations, maxCapacity);
+    int totalProfit = 0;
+    for (const Station& station : selectedStations) {
+        totalProfit += station.profit;
+    }
+
+    bool sameSelection = compactStations.size() == selectedStations.size();
+    for (size_t i = 0; sameSelection && i < compactStations.size(); ++i) {
+        sameSelection = compactStations[i].name == selectedStations[i].name;
+    }
+    sameSelection = sameSelection && parallelStations.size() == selectedStations.size();
+    for (size_t i = 0; sameSelection && i < parallelStations.size(); ++i) {
+        sameSelection = parallelStations[i].name == selectedStations[i].name;
+    }
+
+    // The other solvers may pick a different set when several are equally profitable, so compare profit and weight.
+    int bestProfit = knapsackMaxProfit(stations, maxCapacity);
+    for (const vector<Station>& selection : {solveKnapsackDivide(stations, maxCapacity), solveKnapsackPareto(stations, maxCapacity),
+                                             solveKnapsackBranchAndBound(stations, maxCapacity)}) {
+        int profit = 0, weight = 0;
+        for (const Station& station : selection) {
+            profit += station.profit;
+            weight += station.weight;
+        }
+        sameSelection = sameSelection && profit == bestProfit && weight <= maxCapacity;
+    }
+
+    if (!sameSelection || bestProfit != totalProfit) {
+        cerr << "Error: an alternative knapsack solver disagrees with the full table." << endl;
+        return 1;
+    }
+    cout << "Total Profit: " << totalProfit << " (all solvers match)" << endl;
+
+    // One DP pass answers the whole range of truck capacities.
+    vector<int> capacities = {200, 400, 600, 800, 1000};
+    cout << "Capacity batch:" << endl;
+    for (const KnapsackAnswer& answer : solveKnapsackBatch(stations, capacities)) {
+        cout << "Capacity: " << answer.capacity << " Profit: " << answer.profit << " Stations:";
+        for (const Station& station : answer.stations) {
+            cout << " " << station.name;
+        }
+        cout << endl;
+    }
+
     return 0;
 }